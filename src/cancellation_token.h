@@ -0,0 +1,28 @@
+//==========================================
+// cancellation_token.h - Cooperative cancellation of background work
+//==========================================
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+
+namespace godot {
+
+// Set by whoever decides the work is no longer needed, polled by the work
+// between stages and inside long loops. Whatever was produced before the
+// check is the caller's to recycle.
+class CancellationToken {
+public:
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool is_cancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    // For optional tokens passed down as pointers
+    static bool is_cancelled(const CancellationToken* token) { return token && token->is_cancelled(); }
+
+private:
+    std::atomic<bool> cancelled{false};
+};
+
+}
+
+#endif
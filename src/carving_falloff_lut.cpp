@@ -0,0 +1,63 @@
+//==========================================
+// carving_falloff_lut.cpp
+//==========================================
+#include "carving_falloff_lut.h"
+#include <chrono>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace godot;
+
+void CarvingFalloffLUT::bake(float p_smoothness) {
+    for (int i = 0; i <= RESOLUTION; ++i) {
+        double n = i / (double)RESOLUTION;
+
+        // Combination of cosine and exponential curves for a natural river bed;
+        // higher smoothness gives softer banks
+        double cosine_falloff = 0.5 * (1.0 + std::cos(n * M_PI));
+        double smooth_falloff = std::pow(std::max(cosine_falloff, 0.0), (double)p_smoothness);
+        double exp_factor = std::exp(-n * 2.0);
+        values[i] = (float)(smooth_falloff * (0.7 + 0.3 * exp_factor));
+    }
+    values[RESOLUTION] = 0.0f;
+
+    measure_cost(p_smoothness);
+}
+
+float CarvingFalloffLUT::evaluate(float n, float smoothness) {
+    if (n >= 1.0f) {
+        return 0.0f;
+    }
+    float cosine_falloff = 0.5f * (1.0f + std::cos(n * (float)M_PI));
+    float smooth_falloff = std::pow(std::max(cosine_falloff, 0.0f), smoothness);
+    float exp_factor = std::exp(-n * 2.0f);
+    return smooth_falloff * (0.7f + 0.3f * exp_factor);
+}
+
+void CarvingFalloffLUT::measure_cost(float p_smoothness) {
+    // Sweeps the carving radius and a little beyond, as carving does
+    const int SAMPLES = 4096;
+    const float STEP = 1.25f / SAMPLES;
+    using Clock = std::chrono::steady_clock;
+
+    float sum = 0.0f;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < SAMPLES; ++i) {
+        sum += evaluate(i * STEP, p_smoothness);
+    }
+    Clock::time_point middle = Clock::now();
+    for (int i = 0; i < SAMPLES; ++i) {
+        sum += sample(i * STEP);
+    }
+    Clock::time_point end = Clock::now();
+
+    // Keeps both loops from being optimised away
+    volatile float sink = sum;
+    (void)sink;
+
+    analytic_cost_nsec = std::chrono::duration<double, std::nano>(middle - start).count() / SAMPLES;
+    lookup_cost_nsec = std::chrono::duration<double, std::nano>(end - middle).count() / SAMPLES;
+}
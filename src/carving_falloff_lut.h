@@ -0,0 +1,53 @@
+//==========================================
+// carving_falloff_lut.h - Baked river bed profile for carving
+//==========================================
+#ifndef CARVING_FALLOFF_LUT_H
+#define CARVING_FALLOFF_LUT_H
+
+#include <algorithm>
+
+namespace godot {
+
+// River bed cross-section as a function of normalized distance n = d / radius:
+//   f(n) = (0.5 * (1 + cos(pi * n)))^smoothness * (0.7 + 0.3 * exp(-2n))
+// baked into a table so carving costs a clamp and a lerp instead of
+// cos/pow/exp per sample. With RESOLUTION = 1024 the absolute error against
+// the analytic profile stays below 2.5e-5 for smoothness in [0.5, 5]
+// (f itself is in [0, 1]). Lookups are pure table arithmetic, so every thread
+// gets the same result for the same input. A baked table is published through
+// TerrainConfig and never changed afterwards.
+class CarvingFalloffLUT {
+public:
+    static constexpr int RESOLUTION = 1024; // Segments; the table holds RESOLUTION + 1 values
+
+    explicit CarvingFalloffLUT(float p_smoothness = 2.0f) { bake(p_smoothness); } // TerrainConfig default smoothness
+
+    void bake(float p_smoothness);
+
+    // The profile as the scalar carving path evaluated it, in float, per sample
+    static float evaluate(float n, float smoothness);
+
+    // Nanoseconds per sample for evaluate() and for sample(), timed over the
+    // same inputs by bake(); reported in the chunk stats
+    double get_analytic_cost_nsec() const { return analytic_cost_nsec; }
+    double get_lookup_cost_nsec() const { return lookup_cost_nsec; }
+
+    // n is distance / carving radius; anything at or beyond 1 returns 0
+    float sample(float n) const {
+        float position = std::clamp(n, 0.0f, 1.0f) * RESOLUTION;
+        int index = std::min((int)position, RESOLUTION - 1);
+        float frac = position - index;
+        return values[index] + frac * (values[index + 1] - values[index]);
+    }
+
+private:
+    float values[RESOLUTION + 1];
+    double analytic_cost_nsec = 0.0;
+    double lookup_cost_nsec = 0.0;
+
+    void measure_cost(float p_smoothness);
+};
+
+}
+
+#endif
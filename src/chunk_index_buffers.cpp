@@ -0,0 +1,78 @@
+//==========================================
+// chunk_index_buffers.cpp
+//==========================================
+#include "chunk_index_buffers.h"
+#include "vertex_cache_optimizer.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace godot;
+
+namespace {
+
+std::mutex buffers_mutex;
+// Heap-allocated so no Godot type is destroyed during static destruction
+std::unordered_map<int, PackedInt32Array>* buffers = nullptr;
+
+}
+
+PackedInt32Array ChunkIndexBuffers::get(int segment_count) {
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        if (buffers) {
+            auto it = buffers->find(segment_count);
+            if (it != buffers->end()) {
+                return it->second;
+            }
+        }
+    }
+
+    // Build outside the lock; if two threads race, the first one stored wins
+    PackedInt32Array indices = build(segment_count);
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    if (!buffers) {
+        buffers = new std::unordered_map<int, PackedInt32Array>();
+    }
+    return buffers->try_emplace(segment_count, indices).first->second;
+}
+
+void ChunkIndexBuffers::clear() {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    delete buffers;
+    buffers = nullptr;
+}
+
+PackedInt32Array ChunkIndexBuffers::build(int segment_count) {
+    int vertices_per_row = segment_count + 1;
+    std::vector<int32_t> indices;
+    indices.reserve((size_t)segment_count * segment_count * 6);
+
+    for (int z = 0; z < segment_count; ++z) {
+        int current_row = z * vertices_per_row;
+        int next_row = current_row + vertices_per_row;
+
+        for (int x = 0; x < segment_count; ++x) {
+            int i0 = current_row + x;
+            int i1 = i0 + 1;
+            int i2 = next_row + x;
+            int i3 = i2 + 1;
+
+            indices.push_back(i0);
+            indices.push_back(i1);
+            indices.push_back(i2);
+
+            indices.push_back(i1);
+            indices.push_back(i3);
+            indices.push_back(i2);
+        }
+    }
+
+    optimize_vertex_cache(indices, vertices_per_row * vertices_per_row);
+
+    PackedInt32Array result;
+    result.resize((int64_t)indices.size());
+    std::copy(indices.begin(), indices.end(), result.ptrw());
+    return result;
+}
@@ -0,0 +1,31 @@
+//==========================================
+// chunk_index_buffers.h - Shared index buffers for chunk grids
+//==========================================
+#ifndef CHUNK_INDEX_BUFFERS_H
+#define CHUNK_INDEX_BUFFERS_H
+
+#include <godot_cpp/variant/packed_int32_array.hpp>
+
+namespace godot {
+
+// Every chunk with the same resolution triangulates its vertex grid the same
+// way, so the index list is built once per segment_count, reordered for the
+// post-transform vertex cache, and handed out as a copy-on-write
+// PackedInt32Array that all chunk meshes share on the CPU side.
+//
+// Godot picks 16-bit GPU indices by itself whenever a surface has at most
+// 65535 vertices, i.e. for segment_count <= 254.
+class ChunkIndexBuffers {
+public:
+    static PackedInt32Array get(int segment_count);
+
+    // Releases all buffers; must run before godot-cpp shuts down
+    static void clear();
+
+private:
+    static PackedInt32Array build(int segment_count);
+};
+
+}
+
+#endif
@@ -5,14 +5,16 @@
 #include "terrain_generator.h"
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <algorithm>
-#include <chrono>
+#include <cmath>
 
 using namespace godot;
 
-ChunkManager::ChunkManager(const TerrainConfig* terrain_config, MeshGenerator* mesh_gen,
+ChunkManager::ChunkManager(const TerrainConfig* terrain_config, MeshGenerator* mesh_gen, HeightmapRenderer* heightmap,
                           FoliageGenerator* foliage_gen, RiverGenerator* river_gen, TerrainGenerator* terrain)
-    : config(terrain_config), mesh_generator(mesh_gen), foliage_generator(foliage_gen),
-      river_generator(river_gen), terrain_node(terrain), cached_origin_position(Vector3(0, 0, 0)),
+    : config(terrain_config), mesh_generator(mesh_gen), heightmap_renderer(heightmap), foliage_generator(foliage_gen),
+      river_generator(river_gen), terrain_node(terrain),
+      chunk_reclaimer([this](MeshInstance3D* chunk_mesh) { return return_to_pool(chunk_mesh); }),
+      cached_origin_position(Vector3(0, 0, 0)),
       origin_position_valid(false), should_stop_thread(false), thread_running(false) {
 }
 
@@ -27,6 +29,16 @@ void ChunkManager::start_thread() {
     }
 
     should_stop_thread.store(false);
+
+    // Plan from scratch, as soon as the origin is known
+    chunk_state = ChunkProcessState();
+    chunks_lingering.store(0);
+    load_rescan_requested.store(true);
+    unload_rescan_requested.store(true);
+    origin_notified = false;
+
+    int thread_count = config->generation_threads > 0 ? config->generation_threads : JobPool::default_thread_count();
+    job_pool = std::make_unique<JobPool>(thread_count);
     chunk_loader_thread = std::jthread([this](std::stop_token stop_token) {
         chunk_loader_thread_function(stop_token);
     });
@@ -38,16 +50,52 @@ void ChunkManager::stop_thread() {
         should_stop_thread.store(true);
         chunk_loader_thread.join();
     }
+    job_pool.reset();
 }
 
-void ChunkManager::update_origin_cache(Vector3 origin_position) {
+void ChunkManager::update_origin_cache(Vector3 origin_position, const OriginMotion& motion) {
     cached_origin_position.store(origin_position);
+    cached_origin_motion.store(motion);
     origin_position_valid.store(true);
+
+    // Plans only depend on the origin and prefetch chunks, and on the view
+    // direction for the load order; small changes need no wakeup
+    Vector2i origin_chunk((int)round(origin_position.x / config->width), (int)round(origin_position.z / config->width));
+    Vector2i prefetch_chunk = prefetch_chunk_for(origin_position, motion.velocity);
+    bool turned = motion.view_direction.dot(notified_view_direction) < VIEW_RESORT_COS &&
+                  motion.view_direction != notified_view_direction;
+    if (!origin_notified || origin_chunk != notified_origin_chunk || prefetch_chunk != notified_prefetch_chunk || turned) {
+        notified_origin_chunk = origin_chunk;
+        notified_prefetch_chunk = prefetch_chunk;
+        notified_view_direction = motion.view_direction;
+        origin_notified = true;
+        if (turned) {
+            load_rescan_requested.store(true);
+        }
+        wake_planner();
+    }
+}
+
+void ChunkManager::wake_planner() {
+    {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        planner_signalled = true;
+    }
+    planner_wake.notify_one();
 }
 
 void ChunkManager::process_chunks() {
-    load_chunks();
-    unload_chunks();
+    // Spread scene changes over frames instead of taking them all at once
+    // when the origin crosses a chunk border
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = config->chunk_integration_budget_usec > 0
+        ? start + std::chrono::microseconds(config->chunk_integration_budget_usec)
+        : Clock::time_point::max();
+
+    load_chunks(deadline);
+    apply_lod_updates(deadline);
+    unload_chunks(deadline);
+    last_integration_usec = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
 
     // Handle thread restart if needed
     if (should_stop_thread.load() && !thread_running) {
@@ -62,22 +110,43 @@ void ChunkManager::reload_chunks() {
         return;
     }
 
+    // Wakes the loader thread; start_thread resets the planners on restart
     chunk_loader_thread.request_stop();
     should_stop_thread.store(true);
+}
 
-    // Reset chunk process state so loading/unloading starts from center again
-    chunk_state.load_candidates.clear();
-    chunk_state.load_index = 0;
-    chunk_state.unload_candidates.clear();
-    chunk_state.unload_index = 0;
+void ChunkManager::refresh_lods() {
+    lods_dirty.store(true);
+    wake_planner();
 }
 
 Dictionary ChunkManager::get_chunk_stats() const {
     Dictionary stats;
-    stats["loaded"] = loaded_chunks.size();
-    stats["loading"] = loading_chunks.size();
-    stats["unloading"] = unloading_chunks.size();
-    stats["queued"] = chunk_add_queue.size();
+    stats["loaded"] = chunk_table.count_in(ChunkState::LIVE);
+    stats["loading"] = chunk_table.count_in(ChunkState::READY);
+    stats["unloading"] = chunk_table.count_in(ChunkState::EVICTING);
+    stats["queued"] = chunk_table.count_in(ChunkState::QUEUED);
+    stats["lod_queued"] = chunk_lod_queue.size();
+    stats["pooled"] = chunk_pool.size();
+    stats["reclaim_pending"] = chunk_reclaimer.get_pending_count();
+    stats["height_tiles"] = heightmap_renderer->get_tiles().get_resident_count();
+    stats["generating"] = chunk_table.count_in(ChunkState::GENERATING);
+    stats["cancelled"] = (int64_t)chunks_cancelled.load();
+    stats["lingering"] = (int64_t)chunks_lingering.load();
+    stats["integration_usec"] = last_integration_usec;
+    stats["snapshots_pending"] = (int64_t)config->snapshots.get_pending_count();
+    if (const CarvingFalloffLUT* falloff = config->carving_falloff_lut.get()) {
+        // Per carved sample: the analytic profile carving used to evaluate, and the baked lookup
+        stats["carving_falloff_analytic_nsec"] = falloff->get_analytic_cost_nsec();
+        stats["carving_falloff_lookup_nsec"] = falloff->get_lookup_cost_nsec();
+    }
+    stats["integration_pending"] = (int64_t)(chunk_add_queue.size() + chunk_lod_queue.size() + chunk_evict_queue.size());
+    if (job_pool) {
+        stats["generation_threads"] = job_pool->get_thread_count();
+        stats["jobs_pending"] = (int64_t)job_pool->get_pending_count();
+        stats["jobs_running"] = job_pool->get_active_count();
+        stats["jobs_stolen"] = (int64_t)job_pool->get_steal_count();
+    }
     return stats;
 }
 
@@ -86,17 +155,36 @@ void ChunkManager::chunk_loader_thread_function(std::stop_token stop_token) {
     print_line("Chunk loader thread started.");
 
     while (!stop_token.stop_requested()) {
+        {
+            std::unique_lock<std::mutex> lock(planner_mutex);
+            // Lingering chunks need another look once their time is up, even
+            // if nothing else happens by then
+            if (chunk_state.next_linger_expiry == Clock::time_point::max()) {
+                planner_wake.wait(lock, stop_token, [this]() { return planner_signalled; });
+            } else {
+                planner_wake.wait_until(lock, stop_token, chunk_state.next_linger_expiry,
+                                        [this]() { return planner_signalled; });
+            }
+            planner_signalled = false;
+        }
+        if (stop_token.stop_requested()) {
+            break;
+        }
+
         Vector3 origin_pos = cached_origin_position.load();
         bool position_valid = origin_position_valid.load();
 
         if (position_valid) {
             add_chunks_to_load(origin_pos);
             add_chunks_to_unload(origin_pos);
+            add_chunks_to_relod(origin_pos);
         }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
+    // Nothing may touch the chunk maps once the main thread sees the loader stopped
+    job_pool->cancel_pending();
+    job_pool->wait_idle();
+
     print_line("Chunk loader thread stopped.");
     thread_running = false;
 }
@@ -104,98 +192,253 @@ void ChunkManager::chunk_loader_thread_function(std::stop_token stop_token) {
 void ChunkManager::add_chunks_to_load(Vector3 origin_position) {
     int origin_chunk_x = (int)round(origin_position.x / config->width);
     int origin_chunk_z = (int)round(origin_position.z / config->width);
-
-    // If origin changed or candidates exhausted, recalculate
-    if (chunk_state.load_candidates.empty() ||
-        origin_chunk_x != chunk_state.last_origin_chunk_x ||
-        origin_chunk_z != chunk_state.last_origin_chunk_z ||
-        chunk_state.load_index >= chunk_state.load_candidates.size()) {
+    OriginMotion motion = cached_origin_motion.load();
+    Vector2i origin_chunk(origin_chunk_x, origin_chunk_z);
+    Vector2i prefetch_chunk = prefetch_chunk_for(origin_position, motion.velocity);
+
+    // Recalculate when the origin or prefetch chunk changed, the view turned
+    // or chunks became loadable again; otherwise keep dispatching the current
+    // list as the pool frees up
+    bool rescan = load_rescan_requested.exchange(false);
+    if (rescan ||
+        origin_chunk_x != chunk_state.load_origin_chunk_x ||
+        origin_chunk_z != chunk_state.load_origin_chunk_z ||
+        prefetch_chunk != chunk_state.load_prefetch_chunk) {
 
         chunk_state.load_candidates.clear();
         chunk_state.load_index = 0;
-        chunk_state.last_origin_chunk_x = origin_chunk_x;
-        chunk_state.last_origin_chunk_z = origin_chunk_z;
-
-        int view_dist_sq = config->view_distance * config->view_distance;
-
-        for (int z = -config->view_distance; z <= config->view_distance; z++) {
-            for (int x = -config->view_distance; x <= config->view_distance; x++) {
-                int dist_sq = x * x + z * z;
-                if (dist_sq > view_dist_sq) continue;
-
-                Vector2i chunk_pos(origin_chunk_x + x, origin_chunk_z + z);
-
-                if (!loaded_chunks.contains(chunk_pos) &&
-                    !loading_chunks.contains(chunk_pos) &&
-                    !unloading_chunks.contains(chunk_pos)) {
-                    chunk_state.load_candidates.push_back(chunk_pos);
+        chunk_state.load_origin_chunk_x = origin_chunk_x;
+        chunk_state.load_origin_chunk_z = origin_chunk_z;
+        chunk_state.load_prefetch_chunk = prefetch_chunk;
+
+        // Both view discs, around the origin and around where it is heading
+        int min_x = std::min(origin_chunk_x, prefetch_chunk.x) - config->view_distance;
+        int max_x = std::max(origin_chunk_x, prefetch_chunk.x) + config->view_distance;
+        int min_z = std::min(origin_chunk_z, prefetch_chunk.y) - config->view_distance;
+        int max_z = std::max(origin_chunk_z, prefetch_chunk.y) + config->view_distance;
+
+        for (int z = min_z; z <= max_z; z++) {
+            for (int x = min_x; x <= max_x; x++) {
+                Vector2i chunk_pos(x, z);
+                if (!is_in_range(chunk_pos, origin_chunk, prefetch_chunk, config->view_distance)) continue;
+
+                // Anywhere in its lifecycle, including on its way out
+                if (!chunk_table.contains(chunk_pos)) {
+                    // Milliseconds, so the job pool can order by it
+                    int priority = (int)(time_to_visibility(chunk_pos, origin_position, motion) * 1000.0f);
+                    chunk_state.load_candidates.push_back({chunk_pos, priority});
                 }
             }
         }
 
-        // Sort by distance from origin
+        // Soonest visible first
         std::sort(chunk_state.load_candidates.begin(), chunk_state.load_candidates.end(),
-                 [origin_chunk_x, origin_chunk_z](const Vector2i& a, const Vector2i& b) {
-            int da = (a.x - origin_chunk_x) * (a.x - origin_chunk_x) +
-                    (a.y - origin_chunk_z) * (a.y - origin_chunk_z);
-            int db = (b.x - origin_chunk_x) * (b.x - origin_chunk_x) +
-                    (b.y - origin_chunk_z) * (b.y - origin_chunk_z);
-            return da < db;
+                 [](const std::pair<Vector2i, int>& a, const std::pair<Vector2i, int>& b) {
+            return a.second < b.second;
         });
     }
 
-    // Process only one chunk per cycle
-    if (chunk_state.load_index < chunk_state.load_candidates.size()) {
-        const Vector2i& chunk_pos = chunk_state.load_candidates[chunk_state.load_index];
+    // Dispatch in that order while the pool has room. Keeping the backlog short
+    // lets a moving origin re-prioritise instead of waiting behind stale jobs.
+    while (chunk_state.load_index < chunk_state.load_candidates.size() && has_job_capacity()) {
+        auto [chunk_pos, priority] = chunk_state.load_candidates[chunk_state.load_index];
+        chunk_state.load_index++;
 
-        // Get river segments that affect this chunk (for both carving and foliage exclusion)
-        std::vector<RiverSegment> carving_river_segments;
-        std::vector<RiverSegment> foliage_river_segments;
-        
-        if (river_generator) {
-            if (config->enable_river_carving) {
-                carving_river_segments = river_generator->get_river_segments_for_carving(chunk_pos);
-            }
-            // Always get river segments for foliage exclusion (separate from carving)
-            foliage_river_segments = river_generator->get_river_segments_for_foliage(chunk_pos);
+        // Recorded now so LOD rescans see the chunk before its job finishes
+        ChunkLod lod = chunk_lod_for(chunk_pos, origin_chunk_x, origin_chunk_z);
+        auto token = std::make_shared<CancellationToken>();
+        if (!chunk_table.insert(chunk_pos, lod, token)) {
+            continue;
         }
 
-        // Generate the mesh with river carving if enabled, otherwise use standard generation
-        MeshInstance3D *chunk_mesh;
-        if (config->enable_river_carving && !carving_river_segments.empty()) {
-            chunk_mesh = mesh_generator->generate_chunk_mesh_with_rivers(chunk_pos, carving_river_segments);
-        } else {
-            chunk_mesh = mesh_generator->generate_chunk_mesh(chunk_pos);
-        }
+        submit_job([this, chunk_pos, lod, priority, token]() {
+            generate_chunk(chunk_pos, lod, priority, token);
+        }, priority);
+    }
+}
 
-        // Add foliage to the chunk, excluding river areas
-        if (!foliage_river_segments.empty()) {
-            foliage_generator->populate_chunk_foliage_with_rivers(chunk_mesh, chunk_pos, foliage_river_segments);
-        } else {
-            foliage_generator->populate_chunk_foliage(chunk_mesh, chunk_pos);
+bool ChunkManager::has_job_capacity() const {
+    return job_pool->get_pending_count() < (size_t)job_pool->get_thread_count() * 2;
+}
+
+void ChunkManager::submit_job(JobPool::Job job, int priority) {
+    job_pool->submit([this, job = std::move(job)]() {
+        SnapshotDomain::ReadScope scope(config->snapshots);
+        job();
+    }, priority);
+}
+
+Vector2i ChunkManager::prefetch_chunk_for(Vector3 origin_position, Vector3 velocity) const {
+    Vector3 ahead(velocity.x * config->prefetch_time, 0.0f, velocity.z * config->prefetch_time);
+
+    // No further than the view distance, so the two discs always overlap
+    float max_ahead = config->view_distance * config->width;
+    if (ahead.length() > max_ahead) {
+        ahead = ahead.normalized() * max_ahead;
+    }
+    Vector3 predicted = origin_position + ahead;
+    return Vector2i((int)round(predicted.x / config->width), (int)round(predicted.z / config->width));
+}
+
+bool ChunkManager::is_in_range(Vector2i chunk_pos, Vector2i origin_chunk, Vector2i prefetch_chunk, int distance) const {
+    int dist_sq = distance * distance;
+    int dx = chunk_pos.x - origin_chunk.x;
+    int dz = chunk_pos.y - origin_chunk.y;
+    if (dx * dx + dz * dz <= dist_sq) {
+        return true;
+    }
+    dx = chunk_pos.x - prefetch_chunk.x;
+    dz = chunk_pos.y - prefetch_chunk.y;
+    return dx * dx + dz * dz <= dist_sq;
+}
+
+float ChunkManager::time_to_visibility(Vector2i chunk_pos, Vector3 origin_position, const OriginMotion& motion) const {
+    // Chunk centre relative to the origin, on the ground plane
+    Vector2 offset((chunk_pos.x + 0.5f) * config->width - origin_position.x,
+                   (chunk_pos.y + 0.5f) * config->width - origin_position.z);
+    float distance = offset.length();
+    float chunk_radius = config->width * 0.7071f;
+
+    // Time for the origin to close in on it. A still origin is treated as
+    // approaching everything at one chunk per second, so nearer still wins.
+    float closing_speed = 0.0f;
+    if (distance > 0.0f) {
+        closing_speed = std::max(0.0f, (motion.velocity.x * offset.x + motion.velocity.z * offset.y) / distance);
+    }
+    float seconds = distance / (closing_speed + config->width);
+
+    // Outside the view cone it only shows up once the camera turns. Looking
+    // almost straight down, or standing on it, sees it either way.
+    Vector2 forward(motion.view_direction.x, motion.view_direction.z);
+    float forward_length = forward.length();
+    if (forward_length > 0.1f && distance > chunk_radius) {
+        float cos_angle = forward.dot(offset) / (forward_length * distance);
+        float angle = std::acos(std::clamp(cos_angle, -1.0f, 1.0f));
+        float angular_radius = std::asin(std::min(1.0f, chunk_radius / distance));
+        if (angle > motion.view_half_angle + angular_radius) {
+            seconds += config->offscreen_chunk_delay;
         }
-        
-        // Add river sources debug markers to the chunk
-        if (river_generator) {
-            river_generator->add_debug_sources_to_chunk(chunk_mesh, chunk_pos);
-            
-            // Add either proper river meshes or debug river segments
+    }
+    return seconds;
+}
+
+void ChunkManager::generate_chunk(Vector2i chunk_pos, ChunkLod lod, int priority, std::shared_ptr<CancellationToken> token) {
+    // Jobs can sit in the queue long enough for the origin to move on
+    if (token->is_cancelled() || !chunk_table.transition(chunk_pos, ChunkState::QUEUED, ChunkState::GENERATING)) {
+        abandon_chunk(chunk_pos, nullptr);
+        return;
+    }
+
+    // Rasterize the rivers near this chunk once; carving and foliage exclusion both read it.
+    // River tracing is the longest step, so it checks the token as it goes.
+    auto river_field = std::make_shared<RiverDistanceField>();
+    build_river_field(chunk_pos, *river_field, token.get());
+    if (token->is_cancelled()) {
+        abandon_chunk(chunk_pos, nullptr);
+        return;
+    }
+
+    // Generate the mesh with river carving if enabled, otherwise use standard generation.
+    // Reuse a pooled instance (and its mesh buffers) when one is available
+    MeshInstance3D *recycled = chunk_pool.try_dequeue().value_or(nullptr);
+    MeshInstance3D *chunk_mesh;
+    if (config->clipmap_mode) {
+        chunk_mesh = mesh_generator->generate_chunk_container(chunk_pos, recycled);
+    } else if (config->gpu_heightmap) {
+        chunk_mesh = heightmap_renderer->generate_chunk(chunk_pos, *river_field, lod, recycled);
+    } else if (config->enable_river_carving && !river_field->is_empty()) {
+        chunk_mesh = mesh_generator->generate_chunk_mesh_with_rivers(chunk_pos, *river_field, lod, recycled);
+    } else {
+        chunk_mesh = mesh_generator->generate_chunk_mesh(chunk_pos, lod, recycled);
+    }
+    if (token->is_cancelled()) {
+        abandon_chunk(chunk_pos, chunk_mesh);
+        return;
+    }
+
+    // Recorded so the instance is freed with the table if the decoration job never runs
+    chunk_table.set_mesh(chunk_pos, chunk_mesh);
+    wake_planner();
+
+    if (should_stop_thread.load()) {
+        return;
+    }
+
+    // Queued from this job, so it stays on this worker unless another one is idle
+    submit_job([this, chunk_pos, chunk_mesh, river_field, token]() {
+        decorate_chunk(chunk_pos, chunk_mesh, *river_field, token);
+    }, priority);
+}
+
+void ChunkManager::decorate_chunk(Vector2i chunk_pos, MeshInstance3D* chunk_mesh, const RiverDistanceField& river_field,
+                                  std::shared_ptr<CancellationToken> token) {
+    // Add foliage to the chunk, excluding river areas
+    if (!river_field.is_empty()) {
+        foliage_generator->populate_chunk_foliage_with_rivers(chunk_mesh, chunk_pos, river_field, token.get());
+    } else {
+        foliage_generator->populate_chunk_foliage(chunk_mesh, chunk_pos, token.get());
+    }
+    if (token->is_cancelled()) {
+        abandon_chunk(chunk_pos, chunk_mesh);
+        return;
+    }
+
+    // Add river sources debug markers to the chunk
+    if (river_generator) {
+        river_generator->add_debug_sources_to_chunk(chunk_mesh, chunk_pos);
+
+        // Add either proper river meshes or debug river segments. Neither in
+        // clipmap mode, whose surface is not carved.
+        if (!config->clipmap_mode) {
             if (config->enable_river_mesh) {
-                river_generator->add_river_meshes_to_chunk(chunk_mesh, chunk_pos);
+                river_generator->add_river_meshes_to_chunk(chunk_mesh, chunk_pos, token.get());
             } else {
                 river_generator->add_debug_rivers_to_chunk(chunk_mesh, chunk_pos);
             }
         }
+    }
 
-        loading_chunks.insert_or_assign(chunk_pos, chunk_mesh);
+    if (token->is_cancelled()) {
+        abandon_chunk(chunk_pos, chunk_mesh);
+        return;
+    }
 
-        if (should_stop_thread.load()) {
-            print_line("Stopping thread during chunk addition.");
-            return;
-        }
+    if (should_stop_thread.load()) {
+        print_line("Stopping thread during chunk addition.");
+        return;
+    }
 
-        chunk_add_queue.enqueue(chunk_mesh);
-        chunk_state.load_index++;
+    // From here on it is the main thread's, and unloaded like any other chunk
+    chunk_table.transition(chunk_pos, ChunkState::GENERATING, ChunkState::READY);
+    chunk_add_queue.enqueue({chunk_pos, chunk_mesh});
+    wake_planner();
+}
+
+void ChunkManager::abandon_chunk(Vector2i chunk_pos, MeshInstance3D* chunk_mesh) {
+    // Recycled before the chunk is forgotten: once it is, the planner may
+    // dispatch it again, and that job's height tile must survive
+    heightmap_renderer->release_chunk(chunk_pos);
+    if (chunk_mesh) {
+        recycle_chunk(chunk_mesh);
+    }
+
+    chunk_table.erase(chunk_pos);
+    chunks_cancelled.fetch_add(1);
+
+    // The origin may turn back before the next rescan
+    load_rescan_requested.store(true);
+    wake_planner();
+}
+
+void ChunkManager::cancel_out_of_range_jobs(Vector2i origin_chunk, Vector2i prefetch_chunk) {
+    for (const ChunkTable::Entry& entry : chunk_table.snapshot()) {
+        // Once READY the chunk is the main thread's and unloads normally
+        if (entry.state != ChunkState::QUEUED && entry.state != ChunkState::GENERATING) {
+            continue;
+        }
+        if (!is_in_range(entry.chunk_pos, origin_chunk, prefetch_chunk, unload_distance())) {
+            entry.token->cancel();
+        }
     }
 }
 
@@ -203,125 +446,323 @@ void ChunkManager::add_chunks_to_unload(Vector3 origin_position) {
     int origin_chunk_x = (int)round(origin_position.x / config->width);
     int origin_chunk_z = (int)round(origin_position.z / config->width);
 
-    auto loaded_keys = loaded_chunks.keys();
-
-    // If origin changed or candidates exhausted, recalculate
-    if (chunk_state.unload_candidates.empty() ||
-        origin_chunk_x != chunk_state.last_origin_chunk_x ||
-        origin_chunk_z != chunk_state.last_origin_chunk_z ||
-        chunk_state.unload_index >= chunk_state.unload_candidates.size()) {
+    Vector2i origin_chunk(origin_chunk_x, origin_chunk_z);
+    Vector2i prefetch_chunk = prefetch_chunk_for(origin_position, cached_origin_motion.load().velocity);
+
+    // Loaded chunks only fall out of range when the origin moves or new ones
+    // arrive, and are only due for unloading once they have lingered
+    Clock::time_point now = Clock::now();
+    bool rescan = unload_rescan_requested.exchange(false);
+    if (!rescan &&
+        origin_chunk_x == chunk_state.unload_origin_chunk_x &&
+        origin_chunk_z == chunk_state.unload_origin_chunk_z &&
+        prefetch_chunk == chunk_state.unload_prefetch_chunk &&
+        now < chunk_state.next_linger_expiry) {
+        return;
+    }
+    chunk_state.unload_origin_chunk_x = origin_chunk_x;
+    chunk_state.unload_origin_chunk_z = origin_chunk_z;
+    chunk_state.unload_prefetch_chunk = prefetch_chunk;
+
+    // Chunks still being generated for out there are not worth finishing
+    cancel_out_of_range_jobs(origin_chunk, prefetch_chunk);
+
+    // Handing a chunk to the main thread is cheap, so do them all in one pass.
+    // Prefetched chunks stay while the origin keeps heading their way.
+    auto linger_time = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(std::max(0.0f, config->unload_linger_time)));
+    auto& lingering_since = chunk_state.lingering_since;
+    chunk_state.next_linger_expiry = Clock::time_point::max();
+
+    for (const ChunkTable::Entry& entry : chunk_table.snapshot()) {
+        if (entry.state != ChunkState::LIVE) {
+            continue;
+        }
+        Vector2i chunk_pos = entry.chunk_pos;
+        if (is_in_range(chunk_pos, origin_chunk, prefetch_chunk, unload_distance())) {
+            lingering_since.erase(chunk_pos);  // Back in range before it was unloaded
+            continue;
+        }
 
-        chunk_state.unload_candidates.clear();
-        chunk_state.unload_index = 0;
-        chunk_state.last_origin_chunk_x = origin_chunk_x;
-        chunk_state.last_origin_chunk_z = origin_chunk_z;
+        auto [it, inserted] = lingering_since.try_emplace(chunk_pos, now);
+        Clock::time_point expiry = it->second + linger_time;
+        if (now < expiry) {
+            chunk_state.next_linger_expiry = std::min(chunk_state.next_linger_expiry, expiry);
+            continue;
+        }
 
-        int view_dist_sq = config->view_distance * config->view_distance;
+        lingering_since.erase(it);
+        if (chunk_table.transition(chunk_pos, ChunkState::LIVE, ChunkState::EVICTING)) {
+            chunk_evict_queue.enqueue(chunk_pos);
+        }
+    }
+    chunks_lingering.store(lingering_since.size());
+}
 
-        for (const Vector2i& chunk_pos : loaded_keys) {
-            auto chunk_mesh_opt = loaded_chunks.get(chunk_pos);
-            if (!chunk_mesh_opt.has_value() || !chunk_mesh_opt.value()) {
-                loaded_chunks.erase(chunk_pos);
-                continue;
-            }
+void ChunkManager::add_chunks_to_relod(Vector3 origin_position) {
+    if (config->clipmap_mode) {
+        return; // Chunks carry no terrain surface
+    }
 
-            int dx = chunk_pos.x - origin_chunk_x;
-            int dz = chunk_pos.y - origin_chunk_z;
-            int dist_sq = dx * dx + dz * dz;
+    int origin_chunk_x = (int)round(origin_position.x / config->width);
+    int origin_chunk_z = (int)round(origin_position.z / config->width);
 
-            if (dist_sq > view_dist_sq) {
-                chunk_state.unload_candidates.push_back({chunk_pos, dist_sq});
+    // LODs only depend on the origin chunk and the LOD settings, so rescan
+    // the loaded chunks only when one of those changes
+    bool settings_changed = lods_dirty.exchange(false);
+    if (settings_changed ||
+        origin_chunk_x != chunk_state.lod_origin_chunk_x ||
+        origin_chunk_z != chunk_state.lod_origin_chunk_z) {
+
+        chunk_state.lod_candidates.clear();
+        chunk_state.lod_index = 0;
+        chunk_state.lod_origin_chunk_x = origin_chunk_x;
+        chunk_state.lod_origin_chunk_z = origin_chunk_z;
+
+        // Chunks still on their way to the scene were built for the old origin too
+        for (const ChunkTable::Entry& entry : chunk_table.snapshot()) {
+            if (entry.state != ChunkState::EVICTING &&
+                entry.lod != chunk_lod_for(entry.chunk_pos, origin_chunk_x, origin_chunk_z)) {
+                chunk_state.lod_candidates.push_back(entry.chunk_pos);
             }
         }
 
-        // Sort by distance (furthest first)
-        std::sort(chunk_state.unload_candidates.begin(), chunk_state.unload_candidates.end(),
-                 [](const std::pair<Vector2i, int>& a, const std::pair<Vector2i, int>& b) {
-            return a.second > b.second;
+        // Nearest first; they cover the most screen space
+        std::sort(chunk_state.lod_candidates.begin(), chunk_state.lod_candidates.end(),
+                 [origin_chunk_x, origin_chunk_z](const Vector2i& a, const Vector2i& b) {
+            int da = (a.x - origin_chunk_x) * (a.x - origin_chunk_x) +
+                    (a.y - origin_chunk_z) * (a.y - origin_chunk_z);
+            int db = (b.x - origin_chunk_x) * (b.x - origin_chunk_x) +
+                    (b.y - origin_chunk_z) * (b.y - origin_chunk_z);
+            return da < db;
         });
     }
 
-    // Process only one chunk per cycle
-    if (chunk_state.unload_index < chunk_state.unload_candidates.size()) {
-        const Vector2i& chunk_pos = chunk_state.unload_candidates[chunk_state.unload_index].first;
-        auto chunk_mesh_opt = loaded_chunks.get(chunk_pos);
+    // Only the terrain surface is rebuilt; foliage and river children stay on
+    // the existing instance. New loads get the pool first.
+    while (chunk_state.lod_index < chunk_state.lod_candidates.size() && has_job_capacity()) {
+        Vector2i chunk_pos = chunk_state.lod_candidates[chunk_state.lod_index];
+        chunk_state.lod_index++;
+
+        auto state = chunk_table.get_state(chunk_pos);
+        if (!state.has_value() || state.value() == ChunkState::EVICTING) {
+            continue;
+        }
+
+        // Recorded before the job runs; apply_lod_updates drops any surface
+        // that no longer matches, so overlapping rebuilds cannot go stale
+        ChunkLod lod = chunk_lod_for(chunk_pos, origin_chunk_x, origin_chunk_z);
+        if (!chunk_table.set_lod(chunk_pos, lod)) {
+            continue;
+        }
 
-        if (chunk_mesh_opt.has_value()) {
-            MeshInstance3D *chunk_mesh = chunk_mesh_opt.value();
-            unloading_chunks.insert_or_assign(chunk_pos, chunk_mesh);
-            loaded_chunks.erase(chunk_pos);
+        // Heightmap chunks only swap their grid and edge spans; apply_lod_updates does that
+        if (config->gpu_heightmap) {
+            chunk_lod_queue.enqueue({chunk_pos, lod, Ref<ArrayMesh>()});
+            continue;
         }
 
-        chunk_state.unload_index++;
+        int dx = chunk_pos.x - origin_chunk_x;
+        int dz = chunk_pos.y - origin_chunk_z;
+        submit_job([this, chunk_pos, lod]() {
+            rebuild_chunk_surface(chunk_pos, lod);
+        }, dx * dx + dz * dz);
     }
 }
 
-void ChunkManager::load_chunks() {
-    while (!chunk_add_queue.empty()) {
-        MeshInstance3D *chunk_mesh = chunk_add_queue.dequeue();
-        if (chunk_mesh) {
-            auto chunk_pos_opt = loading_chunks.get_key(chunk_mesh);
-            if (chunk_pos_opt.has_value()) {
-                Vector2i chunk_pos = chunk_pos_opt.value();
-                terrain_node->add_child(chunk_mesh);
-                loaded_chunks.insert_or_assign(chunk_pos, chunk_mesh);
-                loading_chunks.erase(chunk_pos);
-            } else {
-                // Clean up orphaned chunk if not found in loading chunks
-                memdelete(chunk_mesh);
+void ChunkManager::rebuild_chunk_surface(Vector2i chunk_pos, ChunkLod lod) {
+    // Skip rebuilds for chunks that were unloaded or re-targeted since
+    auto is_current = [this, chunk_pos, &lod]() {
+        auto target = chunk_table.get_lod(chunk_pos);
+        return target.has_value() && target.value() == lod &&
+               chunk_table.get_state(chunk_pos) != ChunkState::EVICTING;
+    };
+    if (!is_current()) {
+        return;
+    }
+
+    RiverDistanceField river_field;
+    if (config->enable_river_carving) {
+        build_river_field(chunk_pos, river_field);
+        if (!is_current()) {
+            return;
+        }
+    }
+    Ref<ArrayMesh> mesh = mesh_generator->generate_chunk_surface(chunk_pos, river_field, lod);
+    chunk_lod_queue.enqueue({chunk_pos, lod, mesh});
+    wake_planner();
+}
+
+int ChunkManager::lod_level_for(int chunk_x, int chunk_z, int origin_chunk_x, int origin_chunk_z) const {
+    int max_level = MeshGenerator::max_lod_level(config->segment_count, config->lod_levels);
+    int dx = chunk_x - origin_chunk_x;
+    int dz = chunk_z - origin_chunk_z;
+    float distance = std::sqrt((float)(dx * dx + dz * dz));
+
+    int level = 0;
+    float threshold = (float)config->lod_distance;
+    while (level < max_level && distance >= threshold) {
+        ++level;
+        threshold *= 2.0f;
+    }
+    return level;
+}
+
+ChunkLod ChunkManager::chunk_lod_for(Vector2i chunk_pos, int origin_chunk_x, int origin_chunk_z) const {
+    ChunkLod lod;
+    lod.level = lod_level_for(chunk_pos.x, chunk_pos.y, origin_chunk_x, origin_chunk_z);
+
+    const Vector2i neighbours[ChunkLod::EDGE_MAX] = {
+        Vector2i(chunk_pos.x - 1, chunk_pos.y), Vector2i(chunk_pos.x + 1, chunk_pos.y),
+        Vector2i(chunk_pos.x, chunk_pos.y - 1), Vector2i(chunk_pos.x, chunk_pos.y + 1)
+    };
+    for (int edge = 0; edge < ChunkLod::EDGE_MAX; ++edge) {
+        int neighbour_level = lod_level_for(neighbours[edge].x, neighbours[edge].y, origin_chunk_x, origin_chunk_z);
+        lod.edge_levels[edge] = std::max(lod.level, neighbour_level);
+    }
+    return lod;
+}
+
+void ChunkManager::build_river_field(Vector2i chunk_pos, RiverDistanceField& river_field, const CancellationToken* cancel) const {
+    if (river_generator) {
+        river_generator->build_river_distance_field(chunk_pos, river_field, cancel);
+    }
+}
+
+void ChunkManager::load_chunks(Clock::time_point deadline) {
+    bool loaded_any = false;
+    bool first = true;
+    while (first || Clock::now() < deadline) {
+        first = false;
+        auto queued = chunk_add_queue.try_dequeue();
+        if (!queued.has_value()) {
+            break;
+        }
+        auto [chunk_pos, chunk_mesh] = queued.value();
+        if (chunk_table.transition(chunk_pos, ChunkState::READY, ChunkState::LIVE)) {
+            if (config->gpu_heightmap && !config->clipmap_mode) {
+                heightmap_renderer->attach_chunk(chunk_mesh, chunk_pos);
             }
+            terrain_node->add_child(chunk_mesh);
+            loaded_any = true;
+        } else {
+            // Recycle orphaned chunk if the table no longer expects it
+            recycle_chunk(chunk_mesh);
         }
     }
+
+    // The origin may have moved on while they were generated
+    if (loaded_any) {
+        unload_rescan_requested.store(true);
+        wake_planner();
+    }
 }
 
-void ChunkManager::unload_chunks() {
-    // Process all chunks in unloading state
-    auto unloading_keys = unloading_chunks.keys();
-    for (const Vector2i& chunk_pos : unloading_keys) {
-        auto chunk_mesh_opt = unloading_chunks.get(chunk_pos);
-        if (chunk_mesh_opt.has_value()) {
-            MeshInstance3D* chunk_mesh = chunk_mesh_opt.value();
-            if (chunk_mesh) {
-                if (chunk_mesh->get_parent()) {
-                    terrain_node->remove_child(chunk_mesh);
-                }
-                memdelete(chunk_mesh);
+void ChunkManager::apply_lod_updates(Clock::time_point deadline) {
+    std::vector<LodUpdate> deferred;
+    bool first = true;
+    while (first || Clock::now() < deadline) {
+        first = false;
+        auto update = chunk_lod_queue.try_dequeue();
+        if (!update.has_value()) {
+            break;
+        }
+        // Skip updates for chunks that were unloaded or rebuilt since
+        auto built = chunk_table.get_lod(update->chunk_pos);
+        if (!built.has_value() || built.value() != update->lod) {
+            continue;
+        }
+        auto state = chunk_table.get_state(update->chunk_pos);
+        MeshInstance3D* chunk_mesh = chunk_table.get_mesh(update->chunk_pos);
+        if (state == ChunkState::LIVE && chunk_mesh) {
+            if (!config->gpu_heightmap) {
+                chunk_mesh->set_mesh(update->mesh);
+            } else if (chunk_mesh->get_mesh().is_valid()) {
+                heightmap_renderer->apply_lod(chunk_mesh, update->lod);
             }
+        } else if (state.has_value() && state.value() != ChunkState::EVICTING) {
+            // Its instance has not reached the scene yet; try again next frame
+            deferred.push_back(update.value());
         }
-        unloading_chunks.erase(chunk_pos);
+    }
+    for (const LodUpdate& update : deferred) {
+        chunk_lod_queue.enqueue(update);
     }
 }
 
+void ChunkManager::unload_chunks(Clock::time_point deadline) {
+    // Process chunks in evicting state; the rest wait for the next frame
+    bool unloaded_any = false;
+    bool first = true;
+    while (first || Clock::now() < deadline) {
+        first = false;
+        auto evicted = chunk_evict_queue.try_dequeue();
+        if (!evicted.has_value()) {
+            break;
+        }
+        Vector2i chunk_pos = evicted.value();
+        MeshInstance3D* chunk_mesh = chunk_table.get_mesh(chunk_pos);
+        if (chunk_mesh) {
+            recycle_chunk(chunk_mesh);
+        }
+        heightmap_renderer->release_chunk(chunk_pos);
+        chunk_table.erase(chunk_pos);
+        unloaded_any = true;
+    }
+    if (!unloaded_any) {
+        return;
+    }
+
+    // The origin may have come back for some of them
+    load_rescan_requested.store(true);
+    wake_planner();
+}
+
+void ChunkManager::recycle_chunk(MeshInstance3D* chunk_mesh) {
+    // Detaching is the only part that has to happen on the main thread;
+    // freeing hundreds of foliage nodes is left to the reclaimer
+    if (chunk_mesh->get_parent()) {
+        terrain_node->remove_child(chunk_mesh);
+    }
+    chunk_reclaimer.reclaim(chunk_mesh);
+}
+
+bool ChunkManager::return_to_pool(MeshInstance3D* chunk_mesh) {
+    if (chunk_pool.size() >= MAX_POOLED_CHUNKS) {
+        return false;
+    }
+    // The next job may build it on the other path if gpu_heightmap changed meanwhile
+    heightmap_renderer->reset_chunk(chunk_mesh);
+    chunk_pool.enqueue(chunk_mesh);
+    return true;
+}
+
 void ChunkManager::clear_chunks() {
     print_line("Clearing all chunks...");
 
-    // Helper lambda to clean up chunk maps
-    auto cleanup_chunk_map = [this](auto& chunk_map) {
-        auto keys = chunk_map.keys();
-        for (const Vector2i& chunk_pos : keys) {
-            auto chunk_mesh = chunk_map.get(chunk_pos);
-            if (chunk_mesh.has_value() && chunk_mesh.value()) {
-                if (chunk_mesh.value()->get_parent()) {
-                    terrain_node->remove_child(chunk_mesh.value());
-                }
-                memdelete(chunk_mesh.value());
+    // The table owns every built instance, including the ones still in the
+    // add and evict queues, so each is freed exactly once here
+    for (const ChunkTable::Entry& entry : chunk_table.snapshot()) {
+        if (entry.chunk_mesh) {
+            if (entry.chunk_mesh->get_parent()) {
+                terrain_node->remove_child(entry.chunk_mesh);
             }
+            memdelete(entry.chunk_mesh);
         }
-        chunk_map.clear();
-    };
-
-    cleanup_chunk_map(loaded_chunks);
-    cleanup_chunk_map(loading_chunks);
-    cleanup_chunk_map(unloading_chunks);
+    }
+    chunk_table.clear();
+    heightmap_renderer->clear();
+    while (chunk_add_queue.try_dequeue()) {
+    }
+    while (chunk_evict_queue.try_dequeue()) {
+    }
+    while (chunk_lod_queue.try_dequeue()) {
+    }
 
-    // Clear the chunk add queue
-    while (!chunk_add_queue.empty()) {
-        MeshInstance3D* chunk_mesh = chunk_add_queue.try_dequeue().value_or(nullptr);
-        if (chunk_mesh) {
-            memdelete(chunk_mesh);
-        } else {
-            break;
-        }
+    // The reclaimer may still be adding to the pool
+    chunk_reclaimer.flush();
+    while (auto pooled = chunk_pool.try_dequeue()) {
+        memdelete(pooled.value());
     }
 
     print_line("All chunks cleared.");
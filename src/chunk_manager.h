@@ -6,57 +6,140 @@
 
 #include "terrain_config.h"
 #include "mesh_generator.h"
+#include "heightmap_renderer.h"
 #include "foliage_generator.h"
 #include "river_generator.h"
 #include "safe_queue.h"
-#include "safe_unordered_map.h"
+#include "job_pool.h"
+#include "cancellation_token.h"
+#include "chunk_reclaimer.h"
+#include "chunk_table.h"
 #include <thread>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace godot {
 
 class TerrainGenerator; // Forward declaration
 
+// How the origin moves and looks, sampled by TerrainGenerator each frame
+struct OriginMotion {
+    Vector3 velocity;
+    Vector3 view_direction;        // Zero without a camera; every chunk then counts as in view
+    float view_half_angle = 0.0f;  // Horizontal, in radians
+};
+
 class ChunkManager {
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // Loader thread only. Each planner remembers the origin chunk it last
+    // planned for, so one rescanning never resets another's progress.
     struct ChunkProcessState {
-        std::vector<Vector2i> load_candidates;
+        std::vector<std::pair<Vector2i, int>> load_candidates;  // With their job priority
         size_t load_index = 0;
-        int last_origin_chunk_x = 0;
-        int last_origin_chunk_z = 0;
-        std::vector<std::pair<Vector2i, int>> unload_candidates;
-        size_t unload_index = 0;
+        int load_origin_chunk_x = 0;
+        int load_origin_chunk_z = 0;
+        Vector2i load_prefetch_chunk;
+        int unload_origin_chunk_x = 0;
+        int unload_origin_chunk_z = 0;
+        Vector2i unload_prefetch_chunk;
+        std::unordered_map<Vector2i, Clock::time_point, ChunkTable::Hash> lingering_since;  // Out of range, not yet unloaded
+        Clock::time_point next_linger_expiry = Clock::time_point::max();
+        std::vector<Vector2i> lod_candidates;
+        size_t lod_index = 0;
+        int lod_origin_chunk_x = 0;
+        int lod_origin_chunk_z = 0;
+    };
+
+    // A built chunk waiting for the main thread to add it
+    struct ReadyChunk {
+        Vector2i chunk_pos;
+        MeshInstance3D* chunk_mesh;
+    };
+
+    // A re-LODed surface waiting for the main thread to swap it in
+    struct LodUpdate {
+        Vector2i chunk_pos;
+        ChunkLod lod;
+        Ref<ArrayMesh> mesh;
     };
 
     const TerrainConfig* config;
     MeshGenerator* mesh_generator;
+    HeightmapRenderer* heightmap_renderer;
     FoliageGenerator* foliage_generator;
     RiverGenerator* river_generator;
     TerrainGenerator* terrain_node; // For adding/removing children
 
-    SafeUnorderedMap<Vector2i, MeshInstance3D*, Vector2iHash> loading_chunks;
-    SafeUnorderedMap<Vector2i, MeshInstance3D*, Vector2iHash> loaded_chunks;
-    SafeUnorderedMap<Vector2i, MeshInstance3D*, Vector2iHash> unloading_chunks;
-    SafeQueue<MeshInstance3D*> chunk_add_queue;
+    // Every chunk from dispatch until the main thread removes it, with its
+    // state, LOD, instance and cancellation token. The queues hand READY and
+    // EVICTING chunks to the main thread.
+    ChunkTable chunk_table;
+    SafeQueue<ReadyChunk> chunk_add_queue;
+    SafeQueue<Vector2i> chunk_evict_queue;
+    SafeQueue<LodUpdate> chunk_lod_queue;
+
+    // Unloaded chunk instances, stripped of their children and out of the
+    // scene, waiting to be set up again by a generation job
+    static constexpr int MAX_POOLED_CHUNKS = 32;
+    SafeQueue<MeshInstance3D*> chunk_pool;
+
+    // Strips unloaded chunks off the main thread and refills chunk_pool
+    ChunkReclaimer chunk_reclaimer;
+
+    // The planner cancels QUEUED and GENERATING chunks the origin has left behind
+    std::atomic<uint64_t> chunks_cancelled{0};
+    std::atomic<size_t> chunks_lingering{0};
+
+    // Generation jobs run here; the loader thread only plans and dispatches
+    std::unique_ptr<JobPool> job_pool;
 
     std::jthread chunk_loader_thread;
     std::atomic<Vector3> cached_origin_position{Vector3(0, 0, 0)};
+    std::atomic<OriginMotion> cached_origin_motion{OriginMotion()};
     std::atomic<bool> origin_position_valid{false};
     std::atomic<bool> should_stop_thread{false};  // FIXED: renamed from stop_thread
+    std::atomic<bool> lods_dirty{false};
+    std::atomic<bool> load_rescan_requested{true};    // Chunks left the table
+    std::atomic<bool> unload_rescan_requested{true};  // Chunks went LIVE
     bool thread_running = false;
 
+    // The loader thread sleeps until something worth planning for happens:
+    // the origin crosses a chunk boundary, settings change, a job finishes or
+    // the main thread moves chunks in or out of the scene
+    std::mutex planner_mutex;
+    std::condition_variable_any planner_wake;
+    bool planner_signalled = false;
+    Vector2i notified_origin_chunk;  // Main thread only
+    Vector2i notified_prefetch_chunk;
+    Vector3 notified_view_direction;
+    bool origin_notified = false;
+
+    // Turning the view further than this re-sorts the load candidates
+    static constexpr float VIEW_RESORT_COS = 0.94f;  // ~20 degrees
+
     ChunkProcessState chunk_state;
 
+    // Main thread only
+    int64_t last_integration_usec = 0;
+
 public:
-    ChunkManager(const TerrainConfig* terrain_config, MeshGenerator* mesh_gen,
+    ChunkManager(const TerrainConfig* terrain_config, MeshGenerator* mesh_gen, HeightmapRenderer* heightmap,
                  FoliageGenerator* foliage_gen, RiverGenerator* river_gen, TerrainGenerator* terrain);
     ~ChunkManager();
 
     void start_thread();
     void stop_thread();  // This method name is fine
-    void update_origin_cache(Vector3 origin_position);
+    void update_origin_cache(Vector3 origin_position, const OriginMotion& motion = OriginMotion());
     void process_chunks(); // Called from main thread
     void reload_chunks();
+    void refresh_lods(); // Re-LOD loaded chunks in place after the LOD settings change
     void clear_chunks();
 
     // Debug/stats
@@ -66,8 +149,41 @@ private:
     void chunk_loader_thread_function(std::stop_token stop_token);
     void add_chunks_to_load(Vector3 origin_position);
     void add_chunks_to_unload(Vector3 origin_position);
-    void load_chunks();
-    void unload_chunks();
+    void add_chunks_to_relod(Vector3 origin_position);
+    bool has_job_capacity() const;
+    // Runs the job inside a snapshot read scope, so noise and curve snapshots
+    // it samples are not freed under it
+    void submit_job(JobPool::Job job, int priority);
+
+    // Chunk the origin is predicted to reach within prefetch_time; chunks in
+    // view distance of either it or the origin are loaded, and kept loaded
+    // until they are unload_margin further out
+    Vector2i prefetch_chunk_for(Vector3 origin_position, Vector3 velocity) const;
+    bool is_in_range(Vector2i chunk_pos, Vector2i origin_chunk, Vector2i prefetch_chunk, int distance) const;
+    int unload_distance() const { return config->view_distance + std::max(0, config->unload_margin); }
+    // Estimated seconds until the chunk can be on screen; lower loads first
+    float time_to_visibility(Vector2i chunk_pos, Vector3 origin_position, const OriginMotion& motion) const;
+    void wake_planner();
+
+    // Jobs: build the terrain surface, then decorate it with foliage and rivers
+    void generate_chunk(Vector2i chunk_pos, ChunkLod lod, int priority, std::shared_ptr<CancellationToken> token);
+    void decorate_chunk(Vector2i chunk_pos, MeshInstance3D* chunk_mesh, const RiverDistanceField& river_field,
+                        std::shared_ptr<CancellationToken> token);
+    void rebuild_chunk_surface(Vector2i chunk_pos, ChunkLod lod);
+    // Drops a cancelled chunk's bookkeeping and recycles what it built so far
+    void abandon_chunk(Vector2i chunk_pos, MeshInstance3D* chunk_mesh);
+    void cancel_out_of_range_jobs(Vector2i origin_chunk, Vector2i prefetch_chunk);
+
+    // Each handles at least one item, then stops at the deadline
+    void load_chunks(Clock::time_point deadline);
+    void apply_lod_updates(Clock::time_point deadline);
+    void unload_chunks(Clock::time_point deadline);
+    void recycle_chunk(MeshInstance3D* chunk_mesh);
+    bool return_to_pool(MeshInstance3D* chunk_mesh);
+
+    int lod_level_for(int chunk_x, int chunk_z, int origin_chunk_x, int origin_chunk_z) const;
+    ChunkLod chunk_lod_for(Vector2i chunk_pos, int origin_chunk_x, int origin_chunk_z) const;
+    void build_river_field(Vector2i chunk_pos, RiverDistanceField& river_field, const CancellationToken* cancel = nullptr) const;
 };
 
 }
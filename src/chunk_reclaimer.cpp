@@ -0,0 +1,77 @@
+//==========================================
+// chunk_reclaimer.cpp
+//==========================================
+#include "chunk_reclaimer.h"
+
+using namespace godot;
+
+ChunkReclaimer::ChunkReclaimer(RecycleFunction p_recycle)
+    : recycle(std::move(p_recycle)) {
+    thread = std::jthread([this](std::stop_token stop_token) {
+        thread_function(stop_token);
+    });
+}
+
+ChunkReclaimer::~ChunkReclaimer() {
+    thread.request_stop();
+    thread.join();
+}
+
+void ChunkReclaimer::reclaim(MeshInstance3D* chunk_mesh) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(chunk_mesh);
+    }
+    wake.notify_one();
+}
+
+void ChunkReclaimer::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this]() { return queued.empty() && in_progress == 0; });
+}
+
+size_t ChunkReclaimer::get_pending_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued.size() + in_progress;
+}
+
+void ChunkReclaimer::thread_function(std::stop_token stop_token) {
+    std::vector<MeshInstance3D*> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, stop_token, [this]() { return !queued.empty(); });
+            if (queued.empty()) {
+                return; // Stopping with nothing left
+            }
+            // Everything queued so far is one batch; the lock is not held while freeing
+            batch.swap(queued);
+            in_progress = batch.size();
+        }
+
+        for (MeshInstance3D* chunk_mesh : batch) {
+            reclaim_now(chunk_mesh);
+        }
+        reclaimed.fetch_add(batch.size());
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            in_progress = 0;
+        }
+        drained.notify_all();
+    }
+}
+
+void ChunkReclaimer::reclaim_now(MeshInstance3D* chunk_mesh) {
+    // Foliage and river children are rebuilt per chunk; the instance and its
+    // mesh are what get reused
+    while (chunk_mesh->get_child_count() > 0) {
+        Node* child = chunk_mesh->get_child(0);
+        chunk_mesh->remove_child(child);
+        memdelete(child);
+    }
+    if (!recycle(chunk_mesh)) {
+        memdelete(chunk_mesh);
+    }
+}
@@ -0,0 +1,57 @@
+//==========================================
+// chunk_reclaimer.h - Background teardown of unloaded chunks
+//==========================================
+#ifndef CHUNK_RECLAIMER_H
+#define CHUNK_RECLAIMER_H
+
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+// Frees the foliage and river children of chunks that left the scene, on its
+// own thread and in batches, so the main thread only pays for detaching them.
+// The stripped instance is offered back through `recycle` and freed when that
+// declines it.
+class ChunkReclaimer {
+public:
+    // Takes ownership of the stripped instance when it returns true; any thread
+    using RecycleFunction = std::function<bool(MeshInstance3D*)>;
+
+    explicit ChunkReclaimer(RecycleFunction recycle);
+    ~ChunkReclaimer();  // Reclaims whatever is still queued, then joins
+
+    // Any thread. The instance must already be out of the scene tree.
+    void reclaim(MeshInstance3D* chunk_mesh);
+
+    // Blocks until everything queued so far has been reclaimed
+    void flush();
+
+    size_t get_pending_count() const;
+    uint64_t get_reclaimed_count() const { return reclaimed.load(); }
+
+private:
+    RecycleFunction recycle;
+
+    mutable std::mutex mutex;
+    std::condition_variable_any wake;
+    std::condition_variable drained;
+    std::vector<MeshInstance3D*> queued;
+    size_t in_progress = 0;  // Taken by the thread, not yet reclaimed
+    std::atomic<uint64_t> reclaimed{0};
+
+    std::jthread thread;
+
+    void thread_function(std::stop_token stop_token);
+    void reclaim_now(MeshInstance3D* chunk_mesh);
+};
+
+}
+
+#endif
@@ -0,0 +1,222 @@
+//==========================================
+// chunk_table.cpp
+//==========================================
+#include "chunk_table.h"
+
+using namespace godot;
+
+ChunkTable::ChunkTable()
+    : slots(std::make_unique<Slot[]>(INITIAL_CAPACITY)), capacity(INITIAL_CAPACITY) {
+}
+
+uint64_t ChunkTable::hash(Vector2i chunk_pos) {
+    // splitmix64 finaliser: every input bit reaches every output bit, unlike
+    // Vector2iHash's xor, which sends whole diagonals to the same bucket
+    uint64_t key = ((uint64_t)(uint32_t)chunk_pos.x << 32) | (uint32_t)chunk_pos.y;
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+size_t ChunkTable::find_slot(Vector2i chunk_pos) const {
+    size_t mask = capacity - 1;
+    for (size_t i = hash(chunk_pos) & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (!slot.used) {
+            return capacity;
+        }
+        if (slot.chunk_pos == chunk_pos) {
+            return i;
+        }
+    }
+}
+
+void ChunkTable::move_slot(Slot& to, Slot& from) {
+    to.used = true;
+    to.chunk_pos = from.chunk_pos;
+    to.state.store(from.state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    to.lod.store(from.lod.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    to.chunk_mesh.store(from.chunk_mesh.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    to.token = std::move(from.token);
+}
+
+void ChunkTable::grow() {
+    size_t old_capacity = capacity;
+    std::unique_ptr<Slot[]> old_slots = std::move(slots);
+    capacity = old_capacity * 2;
+    slots = std::make_unique<Slot[]>(capacity);
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (!old_slots[i].used) {
+            continue;
+        }
+        size_t j = hash(old_slots[i].chunk_pos) & mask;
+        while (slots[j].used) {
+            j = (j + 1) & mask;
+        }
+        move_slot(slots[j], old_slots[i]);
+    }
+}
+
+bool ChunkTable::insert(Vector2i chunk_pos, const ChunkLod& lod, std::shared_ptr<CancellationToken> token) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (find_slot(chunk_pos) != capacity) {
+        return false;
+    }
+    if ((count.load() + 1) * 2 > capacity) {
+        grow();
+    }
+
+    size_t mask = capacity - 1;
+    size_t i = hash(chunk_pos) & mask;
+    while (slots[i].used) {
+        i = (i + 1) & mask;
+    }
+    Slot& slot = slots[i];
+    slot.used = true;
+    slot.chunk_pos = chunk_pos;
+    slot.state.store((uint8_t)ChunkState::QUEUED);
+    slot.lod.store(pack_lod(lod));
+    slot.chunk_mesh.store(nullptr);
+    slot.token = std::move(token);
+
+    count.fetch_add(1);
+    state_counts[(int)ChunkState::QUEUED].fetch_add(1);
+    return true;
+}
+
+bool ChunkTable::erase(Vector2i chunk_pos) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    size_t hole = find_slot(chunk_pos);
+    if (hole == capacity) {
+        return false;
+    }
+    count.fetch_sub(1);
+    state_counts[slots[hole].state.load()].fetch_sub(1);
+
+    // Shift the rest of the probe run back over the hole instead of leaving a
+    // tombstone, so lookups never scan past chunks that are long gone
+    size_t mask = capacity - 1;
+    for (size_t i = (hole + 1) & mask; slots[i].used; i = (i + 1) & mask) {
+        size_t home = hash(slots[i].chunk_pos) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            move_slot(slots[hole], slots[i]);
+            hole = i;
+        }
+    }
+
+    Slot& slot = slots[hole];
+    slot.used = false;
+    slot.chunk_mesh.store(nullptr);
+    slot.token.reset();
+    return true;
+}
+
+void ChunkTable::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    slots = std::make_unique<Slot[]>(INITIAL_CAPACITY);
+    capacity = INITIAL_CAPACITY;
+    count.store(0);
+    for (auto& state_count : state_counts) {
+        state_count.store(0);
+    }
+}
+
+bool ChunkTable::contains(Vector2i chunk_pos) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return find_slot(chunk_pos) != capacity;
+}
+
+std::optional<ChunkState> ChunkTable::get_state(Vector2i chunk_pos) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t i = find_slot(chunk_pos);
+    if (i == capacity) {
+        return std::nullopt;
+    }
+    return (ChunkState)slots[i].state.load();
+}
+
+bool ChunkTable::transition(Vector2i chunk_pos, ChunkState from, ChunkState to) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t i = find_slot(chunk_pos);
+    if (i == capacity) {
+        return false;
+    }
+    uint8_t expected = (uint8_t)from;
+    if (!slots[i].state.compare_exchange_strong(expected, (uint8_t)to)) {
+        return false;
+    }
+    state_counts[(int)from].fetch_sub(1);
+    state_counts[(int)to].fetch_add(1);
+    return true;
+}
+
+std::optional<ChunkLod> ChunkTable::get_lod(Vector2i chunk_pos) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t i = find_slot(chunk_pos);
+    if (i == capacity) {
+        return std::nullopt;
+    }
+    return unpack_lod(slots[i].lod.load());
+}
+
+bool ChunkTable::set_lod(Vector2i chunk_pos, const ChunkLod& lod) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t i = find_slot(chunk_pos);
+    if (i == capacity) {
+        return false;
+    }
+    slots[i].lod.store(pack_lod(lod));
+    return true;
+}
+
+MeshInstance3D* ChunkTable::get_mesh(Vector2i chunk_pos) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t i = find_slot(chunk_pos);
+    return i == capacity ? nullptr : slots[i].chunk_mesh.load();
+}
+
+bool ChunkTable::set_mesh(Vector2i chunk_pos, MeshInstance3D* chunk_mesh) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t i = find_slot(chunk_pos);
+    if (i == capacity) {
+        return false;
+    }
+    slots[i].chunk_mesh.store(chunk_mesh);
+    return true;
+}
+
+std::vector<ChunkTable::Entry> ChunkTable::snapshot() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<Entry> entries;
+    entries.reserve(count.load());
+    for (size_t i = 0; i < capacity; ++i) {
+        const Slot& slot = slots[i];
+        if (slot.used) {
+            entries.push_back({slot.chunk_pos, (ChunkState)slot.state.load(), unpack_lod(slot.lod.load()),
+                               slot.chunk_mesh.load(), slot.token});
+        }
+    }
+    return entries;
+}
+
+uint32_t ChunkTable::pack_lod(const ChunkLod& lod) {
+    uint32_t packed = (uint32_t)lod.level & 0x3f;
+    for (int edge = 0; edge < ChunkLod::EDGE_MAX; ++edge) {
+        packed |= ((uint32_t)lod.edge_levels[edge] & 0x3f) << (6 * (edge + 1));
+    }
+    return packed;
+}
+
+ChunkLod ChunkTable::unpack_lod(uint32_t packed) {
+    ChunkLod lod;
+    lod.level = (int)(packed & 0x3f);
+    for (int edge = 0; edge < ChunkLod::EDGE_MAX; ++edge) {
+        lod.edge_levels[edge] = (int)((packed >> (6 * (edge + 1))) & 0x3f);
+    }
+    return lod;
+}
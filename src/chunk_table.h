@@ -0,0 +1,112 @@
+//==========================================
+// chunk_table.h - Lifecycle state of every chunk in flight or in the scene
+//==========================================
+#ifndef CHUNK_TABLE_H
+#define CHUNK_TABLE_H
+
+#include "terrain_config.h"
+#include "cancellation_token.h"
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace godot {
+
+// A chunk only ever moves forward through these:
+//   QUEUED -> GENERATING -> READY -> LIVE -> EVICTING
+// It leaves the table when its job is cancelled before READY, or once the
+// main thread has taken it out of the scene.
+enum class ChunkState : uint8_t {
+    QUEUED,      // Generation job dispatched, not started
+    GENERATING,  // A job is building or decorating the instance
+    READY,       // Built, waiting for the main thread to add it
+    LIVE,        // In the scene
+    EVICTING,    // Out of range, waiting for the main thread to remove it
+    STATE_MAX
+};
+
+// One table keyed by chunk coordinate for the whole lifecycle, in place of a
+// map per stage. Open addressing with linear probing over a strongly mixed
+// hash, so neighbouring chunks do not pile up in one probe run. Adding and
+// removing chunks takes the lock exclusively; everything else shares it, and
+// the state, LOD and instance of an entry are atomics, so the planner, the
+// jobs and the main thread rarely wait on each other.
+class ChunkTable {
+public:
+    // Copy of one entry, as returned by snapshot()
+    struct Entry {
+        Vector2i chunk_pos;
+        ChunkState state;
+        ChunkLod lod;
+        MeshInstance3D* chunk_mesh;
+        std::shared_ptr<CancellationToken> token;
+    };
+
+    // The table's mixed hash, for other containers keyed by chunk coordinate
+    struct Hash {
+        size_t operator()(const Vector2i& chunk_pos) const { return (size_t)ChunkTable::hash(chunk_pos); }
+    };
+
+    ChunkTable();
+
+    // Adds the chunk as QUEUED; false if it is already in the table
+    bool insert(Vector2i chunk_pos, const ChunkLod& lod, std::shared_ptr<CancellationToken> token);
+    bool erase(Vector2i chunk_pos);
+    void clear();
+
+    bool contains(Vector2i chunk_pos) const;
+    std::optional<ChunkState> get_state(Vector2i chunk_pos) const;
+    // Moves the chunk to `to` only if it is still in `from`
+    bool transition(Vector2i chunk_pos, ChunkState from, ChunkState to);
+
+    // LOD the chunk is (being) built with
+    std::optional<ChunkLod> get_lod(Vector2i chunk_pos) const;
+    bool set_lod(Vector2i chunk_pos, const ChunkLod& lod);
+
+    // Set once the job has built the instance
+    MeshInstance3D* get_mesh(Vector2i chunk_pos) const;
+    bool set_mesh(Vector2i chunk_pos, MeshInstance3D* chunk_mesh);
+
+    // Each entry is consistent on its own, not with the others
+    std::vector<Entry> snapshot() const;
+
+    size_t size() const { return count.load(); }
+    size_t count_in(ChunkState state) const { return state_counts[(int)state].load(); }
+
+private:
+    struct Slot {
+        bool used = false;
+        Vector2i chunk_pos;
+        std::atomic<uint8_t> state{0};
+        std::atomic<uint32_t> lod{0};  // Packed, see pack_lod
+        std::atomic<MeshInstance3D*> chunk_mesh{nullptr};
+        std::shared_ptr<CancellationToken> token;  // Fixed while the chunk is in the table
+    };
+
+    static constexpr size_t INITIAL_CAPACITY = 256;  // Power of two; kept at most half full
+
+    mutable std::shared_mutex mutex;
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity = 0;
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> state_counts[(int)ChunkState::STATE_MAX] = {};
+
+    static uint64_t hash(Vector2i chunk_pos);
+    // Slot holding the chunk, or capacity when it is absent. Caller holds the lock.
+    size_t find_slot(Vector2i chunk_pos) const;
+    void grow();
+    static void move_slot(Slot& to, Slot& from);
+
+    // Six bits per level, which is far more than any LOD chain needs
+    static uint32_t pack_lod(const ChunkLod& lod);
+    static ChunkLod unpack_lod(uint32_t packed);
+};
+
+}
+
+#endif
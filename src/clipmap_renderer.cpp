@@ -0,0 +1,293 @@
+//==========================================
+// clipmap_renderer.cpp
+//==========================================
+#include "clipmap_renderer.h"
+#include "vertex_cache_optimizer.h"
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace godot;
+
+namespace {
+
+// Grid of cells_x by cells_z cells in cell units from its corner
+Ref<ArrayMesh> build_grid_mesh(int cells_x, int cells_z) {
+    int vertices_per_row = cells_x + 1;
+    int vertex_count = vertices_per_row * (cells_z + 1);
+    PackedVector3Array vertices;
+    PackedVector3Array normals;
+    vertices.resize(vertex_count);
+    normals.resize(vertex_count);
+    Vector3* vertex_out = vertices.ptrw();
+    Vector3* normal_out = normals.ptrw();
+    for (int z = 0; z <= cells_z; ++z) {
+        for (int x = 0; x <= cells_x; ++x) {
+            vertex_out[z * vertices_per_row + x] = Vector3((float)x, 0.0f, (float)z);
+            normal_out[z * vertices_per_row + x] = Vector3(0.0f, 1.0f, 0.0f);
+        }
+    }
+
+    std::vector<int32_t> triangles;
+    triangles.reserve((size_t)cells_x * cells_z * 6);
+    for (int z = 0; z < cells_z; ++z) {
+        for (int x = 0; x < cells_x; ++x) {
+            int i0 = z * vertices_per_row + x;
+            int i1 = i0 + 1;
+            int i2 = i0 + vertices_per_row;
+            int i3 = i2 + 1;
+            triangles.insert(triangles.end(), {i0, i1, i2, i1, i3, i2});
+        }
+    }
+    optimize_vertex_cache(triangles, vertex_count);
+
+    PackedInt32Array indices;
+    indices.resize((int64_t)triangles.size());
+    std::copy(triangles.begin(), triangles.end(), indices.ptrw());
+
+    Array arrays;
+    arrays.resize(Mesh::ARRAY_MAX);
+    arrays[Mesh::ARRAY_VERTEX] = vertices;
+    arrays[Mesh::ARRAY_NORMAL] = normals;
+    arrays[Mesh::ARRAY_INDEX] = indices;
+
+    Ref<ArrayMesh> mesh;
+    mesh.instantiate();
+    mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    return mesh;
+}
+
+}
+
+ClipmapRenderer::ClipmapRenderer(const TerrainConfig* terrain_config, const HeightSampler* sampler, Node3D* terrain)
+    : config(terrain_config), height_sampler(sampler), terrain_node(terrain) {
+}
+
+ClipmapRenderer::~ClipmapRenderer() {
+    clear();
+}
+
+void ClipmapRenderer::update(Vector3 origin_position) {
+    if (!clipmap) {
+        create_levels();
+    }
+    if (height_sampler->get_generation() != height_generation) {
+        height_generation = height_sampler->get_generation();
+        clipmap->invalidate();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    clipmap->set_center(origin_position.x, origin_position.z);
+    last_update_lines = clipmap->update(config->clipmap_updates_per_frame);
+    last_update_usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    refresh_material();
+    for (int l = 0; l < clipmap->get_level_count(); ++l) {
+        // A level being refilled keeps its last upload; the last row marks it dirty again
+        if (clipmap->take_dirty(l) && clipmap->is_level_ready(l)) {
+            upload_level(l);
+        }
+    }
+    refresh_instances();
+}
+
+void ClipmapRenderer::clear() {
+    for (LevelView& view : level_views) {
+        for (Piece& piece : view.pieces) {
+            if (piece.instance->get_parent()) {
+                terrain_node->remove_child(piece.instance);
+            }
+            memdelete(piece.instance);
+        }
+    }
+    level_views.clear();
+    layer_images.clear();
+    clipmap.reset();
+}
+
+Dictionary ClipmapRenderer::get_stats() const {
+    Dictionary stats;
+    stats["levels"] = clipmap ? clipmap->get_level_count() : 0;
+    stats["settled"] = clipmap ? clipmap->is_settled() : false;
+    stats["lines_last_frame"] = last_update_lines;
+    stats["update_usec"] = last_update_usec;
+    stats["lines_total"] = clipmap ? (int64_t)clipmap->get_lines_updated() : (int64_t)0;
+    stats["samples_total"] = clipmap ? (int64_t)clipmap->get_samples_updated() : (int64_t)0;
+    return stats;
+}
+
+void ClipmapRenderer::create_levels() {
+    float spacing = config->width / (float)config->segment_count;
+    clipmap = std::make_unique<HeightClipmap>(height_sampler, spacing, config->clipmap_levels, config->clipmap_size);
+    height_generation = height_sampler->get_generation();
+
+    int samples = clipmap->get_sample_count();
+    Ref<Image> blank = Image::create_empty(samples, samples, false, Image::FORMAT_RF);
+    layer_images.assign(clipmap->get_level_count(), blank);
+    TypedArray<Ref<Image>> images;
+    for (const Ref<Image>& image : layer_images) {
+        images.push_back(image);
+    }
+    if (height_texture.is_null()) {
+        height_texture.instantiate();
+    }
+    height_texture->create_from_images(images);
+
+    // Offsets along either axis: two blocks, the two-cell fix-up gap, two blocks
+    int block = clipmap->get_block_size() - 1;
+    int interior = 2 * block + 2;
+    const int offsets[4] = {0, block, interior, interior + block};
+    block_mesh = build_grid_mesh(block, block);
+    fixup_x_mesh = build_grid_mesh(block, 2);
+    fixup_z_mesh = build_grid_mesh(2, block);
+    trim_x_mesh = build_grid_mesh(interior, 1);
+    trim_z_mesh = build_grid_mesh(1, interior - 1);
+    interior_mesh = build_grid_mesh(interior, interior);
+
+    level_views.resize(clipmap->get_level_count());
+    for (int l = 0; l < clipmap->get_level_count(); ++l) {
+        std::vector<Piece>& pieces = level_views[l].pieces;
+        pieces.reserve(PIECE_COUNT);
+        for (int z = 0; z < 4; ++z) {
+            for (int x = 0; x < 4; ++x) {
+                bool inside = (x == 1 || x == 2) && (z == 1 || z == 2);
+                if (!inside) {
+                    pieces.push_back(create_piece(l, block_mesh, Vector2i(block, block), Vector2i(offsets[x], offsets[z])));
+                }
+            }
+        }
+        pieces.push_back(create_piece(l, fixup_z_mesh, Vector2i(2, block), Vector2i(2 * block, 0)));
+        pieces.push_back(create_piece(l, fixup_z_mesh, Vector2i(2, block), Vector2i(2 * block, interior + block)));
+        pieces.push_back(create_piece(l, fixup_x_mesh, Vector2i(block, 2), Vector2i(0, 2 * block)));
+        pieces.push_back(create_piece(l, fixup_x_mesh, Vector2i(block, 2), Vector2i(interior + block, 2 * block)));
+        pieces.push_back(create_piece(l, trim_x_mesh, Vector2i(interior, 1), Vector2i(block, block)));
+        pieces.push_back(create_piece(l, trim_z_mesh, Vector2i(1, interior - 1), Vector2i(block, block)));
+        pieces.push_back(create_piece(l, interior_mesh, Vector2i(interior, interior), Vector2i(block, block)));
+    }
+    // New instances need the material
+    material_resolved = false;
+}
+
+ClipmapRenderer::Piece ClipmapRenderer::create_piece(int level, const Ref<ArrayMesh>& mesh, Vector2i cells, Vector2i offset) {
+    Piece piece;
+    piece.instance = memnew(MeshInstance3D);
+    piece.instance->set_visible(false);
+    piece.instance->set_mesh(mesh);
+    piece.instance->set_instance_shader_parameter("clipmap_layer", level);
+    piece.instance->set_instance_shader_parameter("clipmap_cell_size", clipmap->get_spacing(level));
+    piece.cells = cells;
+    place_piece(level, piece, offset);
+    terrain_node->add_child(piece.instance);
+    return piece;
+}
+
+void ClipmapRenderer::place_piece(int level, Piece& piece, Vector2i offset) {
+    // The shader moves the vertices, so the bounds come from where they end up
+    const LevelView& view = level_views[level];
+    float spacing = clipmap->get_spacing(level);
+    const Vector2& range = view.height_range;
+    piece.offset = offset;
+    piece.instance->set_instance_shader_parameter("clipmap_offset", Vector2((float)offset.x, (float)offset.y));
+    piece.instance->set_custom_aabb(AABB(Vector3((view.origin_x + offset.x) * spacing, range.x, (view.origin_z + offset.y) * spacing),
+                                         Vector3(piece.cells.x * spacing, range.y - range.x, piece.cells.y * spacing)));
+}
+
+void ClipmapRenderer::refresh_material() {
+    if (material_resolved && source_material == config->terrain_material) {
+        return;
+    }
+    material_resolved = true;
+    source_material = config->terrain_material;
+    material = Ref<ShaderMaterial>();
+
+    Ref<ShaderMaterial> shader_material = source_material;
+    if (shader_material.is_null()) {
+        UtilityFunctions::push_warning("clipmap_mode needs a ShaderMaterial using the terrain shader; the clipmap will render flat");
+    } else {
+        // A copy, so the clipmap uniforms are never saved into the user's material
+        material = shader_material->duplicate();
+        material->set_shader_parameter("use_clipmap", true);
+        material->set_shader_parameter("clipmap_heights", height_texture);
+    }
+
+    Ref<Material> override = material.is_valid() ? Ref<Material>(material) : source_material;
+    for (LevelView& view : level_views) {
+        for (Piece& piece : view.pieces) {
+            piece.instance->set_material_override(override);
+        }
+    }
+}
+
+void ClipmapRenderer::upload_level(int level) {
+    // The layer mirrors the toroidal buffer; the shader does the wrapping
+    const HeightClipmap::Level& data = clipmap->get_level(level);
+    int samples = clipmap->get_sample_count();
+    PackedByteArray bytes;
+    bytes.resize(data.samples.size() * sizeof(float));
+    std::memcpy(bytes.ptrw(), data.samples.data(), data.samples.size() * sizeof(float));
+    layer_images[level] = Image::create_from_data(samples, samples, false, Image::FORMAT_RF, bytes);
+    height_texture->update_layer(layer_images[level], level);
+
+    // The origin moves with the data, so both change in the same frame
+    LevelView& view = level_views[level];
+    auto range = std::minmax_element(data.samples.begin(), data.samples.end());
+    view.uploaded = true;
+    view.origin_x = data.origin_x;
+    view.origin_z = data.origin_z;
+    view.height_range = Vector2(*range.first, *range.second);
+    for (Piece& piece : view.pieces) {
+        piece.instance->set_instance_shader_parameter("clipmap_origin", Vector2((float)data.origin_x, (float)data.origin_z));
+        place_piece(level, piece, piece.offset);
+    }
+}
+
+void ClipmapRenderer::refresh_instances() {
+    // Every level is drawn from its last upload, so a refill after a jump or
+    // a height change never leaves a gap
+    int count = clipmap->get_level_count();
+    int block = clipmap->get_block_size() - 1;
+    int interior = 2 * block + 2;
+    for (int level = 0; level < count; ++level) {
+        LevelView& view = level_views[level];
+        std::vector<Piece>& pieces = view.pieces;
+
+        // The finer level starts block or block + 1 cells in; the trim strips
+        // take the cell it leaves free on each axis. Until the levels catch
+        // up after a jump they may not nest, and the interior patch covers
+        // the hole underneath the finer level.
+        bool nested = false;
+        Vector2i inner_offset;
+        if (view.uploaded && level > 0 && level_views[level - 1].uploaded) {
+            const LevelView& inner = level_views[level - 1];
+            nested = clipmap->is_nested(inner.origin_x, view.origin_x) && clipmap->is_nested(inner.origin_z, view.origin_z);
+            inner_offset = Vector2i(inner.origin_x / 2 - view.origin_x, inner.origin_z / 2 - view.origin_z);
+        }
+        if (nested) {
+            int trim_x = inner_offset.x == block ? interior + block - 1 : block;
+            int trim_z = inner_offset.y == block ? interior + block - 1 : block;
+            Vector2i row(block, trim_z);
+            Vector2i column(trim_x, inner_offset.y);
+            if (pieces[PIECE_TRIM_X].offset != row) {
+                place_piece(level, pieces[PIECE_TRIM_X], row);
+            }
+            if (pieces[PIECE_TRIM_Z].offset != column) {
+                place_piece(level, pieces[PIECE_TRIM_Z], column);
+            }
+        }
+
+        for (int p = 0; p < PIECE_COUNT; ++p) {
+            bool visible = view.uploaded;
+            if (p == PIECE_TRIM_X || p == PIECE_TRIM_Z) {
+                visible = visible && nested;
+            } else if (p == PIECE_INTERIOR) {
+                visible = visible && !nested;
+            }
+            if (pieces[p].instance->is_visible() != visible) {
+                pieces[p].instance->set_visible(visible);
+            }
+        }
+    }
+}
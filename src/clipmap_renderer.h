@@ -0,0 +1,100 @@
+//==========================================
+// clipmap_renderer.h - Draws the height clipmap around the origin
+//==========================================
+#ifndef CLIPMAP_RENDERER_H
+#define CLIPMAP_RENDERER_H
+
+#include "terrain_config.h"
+#include "height_clipmap.h"
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/classes/texture2d_array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+// Main-thread side of clipmap_mode. Every level is drawn with the same fixed
+// footprint: a ring of twelve blocks and four fix-up strips, plus two trim
+// strips on the sides of the finer level that HeightClipmap leaves a cell
+// free, or an interior patch where no finer level nests. The pieces share a
+// handful of grid meshes in cell units built once; the terrain shader places
+// each one in its level and displaces it from the level's layer of a shared
+// texture array, which mirrors the toroidal HeightClipmap buffers as they are.
+class ClipmapRenderer {
+private:
+    // One instance of a shared mesh, placed in its level's cells
+    struct Piece {
+        MeshInstance3D* instance = nullptr;
+        Vector2i offset;  // Cell of the level where the piece starts
+        Vector2i cells;   // Extent in cells
+    };
+    // The ring's blocks and fix-up strips come first and never move
+    enum {
+        PIECE_TRIM_X = 16,  // Strip along x beside the finer level
+        PIECE_TRIM_Z,       // Strip along z beside it
+        PIECE_INTERIOR,     // Fills the hole when no finer level nests in it
+        PIECE_COUNT
+    };
+    // What a level's layer of the texture holds. HeightClipmap refills a level
+    // in place over several frames; the layer keeps the last complete window
+    // and stays drawn meanwhile, so nothing blanks while a refill runs.
+    struct LevelView {
+        bool uploaded = false;
+        int origin_x = 0;      // Origin of the window in the layer
+        int origin_z = 0;
+        Vector2 height_range;  // Lowest and highest sample in it
+        std::vector<Piece> pieces;
+    };
+
+    const TerrainConfig* config;
+    const HeightSampler* height_sampler;
+    Node3D* terrain_node;  // Parent of the level instances
+
+    std::unique_ptr<HeightClipmap> clipmap;
+    uint32_t height_generation = 0;
+    std::vector<LevelView> level_views;
+    std::vector<Ref<Image>> layer_images;
+    Ref<Texture2DArray> height_texture;
+    Ref<Material> source_material;
+    Ref<ShaderMaterial> material;  // Copy of terrain_material with the clipmap uniforms bound
+    bool material_resolved = false;
+    Ref<ArrayMesh> block_mesh;
+    Ref<ArrayMesh> fixup_x_mesh;     // Two cells deep, between the blocks on the x sides
+    Ref<ArrayMesh> fixup_z_mesh;     // Two cells deep, between the blocks on the z sides
+    Ref<ArrayMesh> trim_x_mesh;
+    Ref<ArrayMesh> trim_z_mesh;
+    Ref<ArrayMesh> interior_mesh;
+
+    int last_update_lines = 0;
+    int64_t last_update_usec = 0;
+
+public:
+    ClipmapRenderer(const TerrainConfig* terrain_config, const HeightSampler* sampler, Node3D* terrain);
+    ~ClipmapRenderer();
+
+    // Moves the clipmap towards origin_position within this frame's line budget
+    void update(Vector3 origin_position);
+
+    // Removes the level instances and drops the height data
+    void clear();
+
+    Dictionary get_stats() const;
+
+private:
+    void create_levels();
+    Piece create_piece(int level, const Ref<ArrayMesh>& mesh, Vector2i cells, Vector2i offset);
+    void place_piece(int level, Piece& piece, Vector2i offset);
+    void refresh_material();
+    void upload_level(int level);
+    void refresh_instances();
+};
+
+}
+
+#endif
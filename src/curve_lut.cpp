@@ -0,0 +1,13 @@
+//==========================================
+// curve_lut.cpp
+//==========================================
+#include "curve_lut.h"
+
+using namespace godot;
+
+void CurveLUT::bake(const Ref<Curve>& p_curve) {
+    for (int i = 0; i <= RESOLUTION; ++i) {
+        float t = i / (float)RESOLUTION;
+        values[i] = p_curve.is_valid() ? p_curve->sample(t) : t;
+    }
+}
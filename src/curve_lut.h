@@ -0,0 +1,53 @@
+//==========================================
+// curve_lut.h - Fixed-resolution lookup table for Curve resources
+//==========================================
+#ifndef CURVE_LUT_H
+#define CURVE_LUT_H
+
+#include <godot_cpp/classes/curve.hpp>
+#include <algorithm>
+
+namespace godot {
+
+// Samples a Curve over [0, 1] into a contiguous table so the height hot path
+// can evaluate it with a clamp and a lerp instead of Curve::sample() through
+// the binding layer. A missing curve bakes to the identity mapping.
+class CurveLUT {
+public:
+    static constexpr int RESOLUTION = 1024; // Segments; the table holds RESOLUTION + 1 values
+
+    CurveLUT() { bake(Ref<Curve>()); }
+
+    void bake(const Ref<Curve>& p_curve);
+
+    float sample(float t) const {
+        float position = std::clamp(t, 0.0f, 1.0f) * RESOLUTION;
+        int index = std::min((int)position, RESOLUTION - 1);
+        float frac = position - index;
+        return values[index] + frac * (values[index + 1] - values[index]);
+    }
+
+    // Value plus the slope of the table at t (zero where t is clamped)
+    float sample_with_derivative(float t, float& r_derivative) const {
+        float position = std::clamp(t, 0.0f, 1.0f) * RESOLUTION;
+        int index = std::min((int)position, RESOLUTION - 1);
+        float frac = position - index;
+        float delta = values[index + 1] - values[index];
+        r_derivative = (t > 0.0f && t < 1.0f) ? delta * RESOLUTION : 0.0f;
+        return values[index] + frac * delta;
+    }
+
+private:
+    float values[RESOLUTION + 1];
+};
+
+// Baked curves of the three height layers, published together
+struct CurveLUTs {
+    CurveLUT continentalness;
+    CurveLUT peaks_and_valleys;
+    CurveLUT erosion;
+};
+
+}
+
+#endif
@@ -2,7 +2,6 @@
 // foliage_generator.cpp
 //==========================================
 #include "foliage_generator.h"
-#include "river_generator.h"
 #include "utils.h"
 #include <cmath>
 
@@ -12,14 +11,14 @@ FoliageGenerator::FoliageGenerator(const TerrainConfig* terrain_config, const He
     : config(terrain_config), height_sampler(sampler) {
 }
 
-void FoliageGenerator::populate_chunk_foliage(MeshInstance3D* chunk_mesh, Vector2i position) {
-    // Call the river-aware version with an empty river list
-    std::vector<RiverSegment> empty_rivers;
-    populate_chunk_foliage_with_rivers(chunk_mesh, position, empty_rivers);
+void FoliageGenerator::populate_chunk_foliage(MeshInstance3D* chunk_mesh, Vector2i position, const CancellationToken* cancel) {
+    // Call the river-aware version with an empty river field
+    RiverDistanceField empty_field;
+    populate_chunk_foliage_with_rivers(chunk_mesh, position, empty_field, cancel);
 }
 
 void FoliageGenerator::populate_chunk_foliage_with_rivers(MeshInstance3D* chunk_mesh, Vector2i position, 
-                                                         const std::vector<RiverSegment>& river_segments) {
+                                                         const RiverDistanceField& river_field, const CancellationToken* cancel) {
     if (!chunk_mesh || !config->foliage_scene.is_valid()) {
         return;
     }
@@ -27,6 +26,9 @@ void FoliageGenerator::populate_chunk_foliage_with_rivers(MeshInstance3D* chunk_
     std::vector<Vector2> foliage_positions = poisson_disc_sample(config->width, config->width, 10.0f, 1.0f);
 
     for (const Vector2& pos : foliage_positions) {
+        if (CancellationToken::is_cancelled(cancel)) {
+            return;
+        }
         if (config->foliage_scene->can_instantiate()) {
             float random_shift_x = random_float(position * config->width + pos * 0.5f) * 5.0f;
             float random_shift_y = random_float(position * config->width + pos) * 5.0f;
@@ -37,12 +39,13 @@ void FoliageGenerator::populate_chunk_foliage_with_rivers(MeshInstance3D* chunk_
             float world_z = position.y * config->width + shifted_pos.y;
 
             // Check if this position is near a river
-            if (is_near_river(world_x, world_z, river_segments)) {
+            if (is_near_river(world_x, world_z, river_field)) {
                 continue; // Skip foliage placement near rivers
             }
 
-            float height = height_sampler->sample_height(world_x, world_z);
-            Vector3 normal = height_sampler->sample_normal(world_x, world_z);
+            Vector2 gradient;
+            float height = height_sampler->sample_height_and_gradient(world_x, world_z, gradient);
+            Vector3 normal = HeightSampler::normal_from_gradient(gradient);
 
             if (!is_suitable_for_foliage(height, normal)) {
                 continue;
@@ -66,42 +69,11 @@ bool FoliageGenerator::is_suitable_for_foliage(float height, const Vector3& norm
     return height >= min_height && normal.y >= min_normal_y;
 }
 
-bool FoliageGenerator::is_near_river(float world_x, float world_z, const std::vector<RiverSegment>& river_segments) const {
-    const float exclusion_radius = config->foliage_river_exclusion_radius;
-
-    for (const RiverSegment& segment : river_segments) {
-        float distance = distance_to_river_segment(world_x, world_z, segment);
-        
-        // Calculate effective exclusion radius based on river width
-        float effective_radius = exclusion_radius + segment.width * 0.5f;
-        
-        if (distance <= effective_radius) {
-            return true; // Too close to river
-        }
+bool FoliageGenerator::is_near_river(float world_x, float world_z, const RiverDistanceField& river_field) const {
+    if (river_field.is_empty()) {
+        return false;
     }
 
-    return false; // Not near any river
+    // Exclusion radius grows with river width: distance to the bank, not the centreline
+    return river_field.sample_bank_distance(world_x, world_z) <= config->foliage_river_exclusion_radius;
 }
-
-float FoliageGenerator::distance_to_river_segment(float world_x, float world_z, const RiverSegment& segment) const {
-    Vector2 point(world_x, world_z);
-    Vector2 line_start = segment.start;
-    Vector2 line_end = segment.end;
-    
-    // Vector from start to end of segment
-    Vector2 segment_vec = line_end - line_start;
-    float segment_length_sq = segment_vec.length_squared();
-    
-    if (segment_length_sq < 0.0001f) {
-        // Degenerate segment, treat as point
-        return point.distance_to(line_start);
-    }
-    
-    // Project point onto line segment
-    Vector2 point_vec = point - line_start;
-    float t = std::max(0.0f, std::min(1.0f, point_vec.dot(segment_vec) / segment_length_sq));
-    
-    // Find closest point on segment
-    Vector2 closest_point = line_start + t * segment_vec;
-    return point.distance_to(closest_point);
-}
\ No newline at end of file
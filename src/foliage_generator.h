@@ -6,14 +6,12 @@
 
 #include "terrain_config.h"
 #include "height_sampler.h"
+#include "cancellation_token.h"
 #include <godot_cpp/classes/mesh_instance3d.hpp>
 #include <vector>
 
 namespace godot {
 
-// Forward declaration
-struct RiverSegment;
-
 class FoliageGenerator {
 private:
     const TerrainConfig* config;
@@ -22,14 +20,14 @@ private:
 public:
     FoliageGenerator(const TerrainConfig* terrain_config, const HeightSampler* sampler);
 
-    void populate_chunk_foliage(MeshInstance3D* chunk_mesh, Vector2i position);
+    // Both stop placing instances once `cancel` is cancelled
+    void populate_chunk_foliage(MeshInstance3D* chunk_mesh, Vector2i position, const CancellationToken* cancel = nullptr);
     void populate_chunk_foliage_with_rivers(MeshInstance3D* chunk_mesh, Vector2i position, 
-                                           const std::vector<RiverSegment>& river_segments);
+                                           const RiverDistanceField& river_field, const CancellationToken* cancel = nullptr);
 
 private:
     bool is_suitable_for_foliage(float height, const Vector3& normal) const;
-    bool is_near_river(float world_x, float world_z, const std::vector<RiverSegment>& river_segments) const;
-    float distance_to_river_segment(float world_x, float world_z, const RiverSegment& segment) const;
+    bool is_near_river(float world_x, float world_z, const RiverDistanceField& river_field) const;
 };
 
 }
@@ -0,0 +1,208 @@
+//==========================================
+// height_clipmap.cpp
+//==========================================
+#include "height_clipmap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace godot;
+
+namespace {
+
+int floor_div(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+}
+
+HeightClipmap::HeightClipmap(const HeightSampler* sampler, float p_base_spacing, int level_count, int p_size)
+    : height_sampler(sampler), base_spacing(p_base_spacing),
+      // 4k - 2 cells: four blocks of k samples and a two-cell fix-up gap per
+      // side, and even, so a level's inner half lands on whole cells
+      size(std::max(6, (p_size + 2) / 4 * 4 - 2)),
+      levels(std::max(level_count, 1)) {
+}
+
+void HeightClipmap::set_center(float world_x, float world_z) {
+    Level& finest = levels[0];
+    float spacing = get_spacing(0);
+    int center_x = (int)std::lround(world_x / spacing);
+    int center_z = (int)std::lround(world_z / spacing);
+
+    // Origins stay on even samples so every level lines up with the samples
+    // of the next coarser one
+    finest.target_x = floor_div(center_x - size / 2, 2) * 2;
+    finest.target_z = floor_div(center_z - size / 2, 2) * 2;
+    follow(0);
+}
+
+int HeightClipmap::update(int max_lines) {
+    // Enough for a scroll that drags every level along
+    max_lines = std::max(max_lines, 2 * (int)levels.size());
+    int done = 0;
+    while (done < max_lines) {
+        // Finest level first: it scrolls most often and covers the most screen
+        int lines = 0;
+        for (int l = 0; l < (int)levels.size() && lines == 0; ++l) {
+            lines = step_level(l, max_lines - done);
+        }
+        if (lines == 0) {
+            break;
+        }
+        done += lines;
+    }
+    lines_updated += done;
+    return done;
+}
+
+void HeightClipmap::invalidate() {
+    for (Level& level : levels) {
+        level.filled_rows = 0;
+        level.dirty = true;
+    }
+}
+
+bool HeightClipmap::is_settled() const {
+    for (int l = 0; l < (int)levels.size(); ++l) {
+        const Level& level = levels[l];
+        if (!is_level_ready(l) || level.origin_x != level.target_x || level.origin_z != level.target_z) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HeightClipmap::take_dirty(int level) {
+    bool dirty = levels[level].dirty;
+    levels[level].dirty = false;
+    return dirty;
+}
+
+bool HeightClipmap::is_nested(int inner_origin, int outer_origin) const {
+    // Origins are even, so the finer window starts on a whole cell
+    int offset = inner_origin / 2 - outer_origin;
+    return offset == get_block_size() - 1 || offset == get_block_size();
+}
+
+float HeightClipmap::get_sample(int level, int lattice_x, int lattice_z) const {
+    return levels[level].samples[wrap(lattice_z) * get_sample_count() + wrap(lattice_x)];
+}
+
+int HeightClipmap::wrap(int lattice) const {
+    int n = get_sample_count();
+    int wrapped = lattice % n;
+    return wrapped < 0 ? wrapped + n : wrapped;
+}
+
+int HeightClipmap::step_level(int level_index, int budget) {
+    Level& level = levels[level_index];
+    int n = get_sample_count();
+
+    // Scrolling further than a refill costs is not worth it
+    int dx = level.target_x - level.origin_x;
+    int dz = level.target_z - level.origin_z;
+    if (level.filled_rows == n && std::abs(dx) + std::abs(dz) >= n) {
+        level.filled_rows = 0;
+    }
+
+    // A refill keeps the origin it started with and scrolls once complete
+    if (level.filled_rows < n) {
+        if (level.filled_rows == 0) {
+            level.origin_x = level.target_x;
+            level.origin_z = level.target_z;
+            level.samples.resize((size_t)n * n);
+            follow(level_index);
+        }
+        fill_row(level_index, level.origin_z + level.filled_rows);
+        level.filled_rows++;
+        level.dirty = true;
+        return 1;
+    }
+    if (dx == 0 && dz == 0) {
+        return 0;
+    }
+
+    // Coarser levels the window would leave move in the same step, so the
+    // levels nest again by the time update() returns. One still refilling
+    // moves to its target when the refill starts, so the scroll waits for it.
+    bool along_x = dx != 0;
+    int direction = (along_x ? dx : dz) > 0 ? 1 : -1;
+    int last = level_index;
+    int inner_origin = (along_x ? level.origin_x : level.origin_z) + 2 * direction;
+    while (last + 1 < (int)levels.size()) {
+        const Level& outer = levels[last + 1];
+        int outer_origin = along_x ? outer.origin_x : outer.origin_z;
+        if (is_nested(inner_origin, outer_origin)) {
+            break;
+        }
+        if (!is_level_ready(last + 1)) {
+            return 0;
+        }
+        inner_origin = outer_origin + 2 * direction;
+        ++last;
+    }
+    int lines = 2 * (last - level_index + 1);
+    if (lines > budget) {
+        return 0;
+    }
+    for (int l = level_index; l <= last; ++l) {
+        scroll_level(l, along_x, direction);
+    }
+    follow(level_index);
+    return lines;
+}
+
+void HeightClipmap::scroll_level(int level_index, bool along_x, int direction) {
+    // Two lines at a time so the origin stays even. The lines that scroll in
+    // reuse the slots of the ones scrolling out.
+    Level& level = levels[level_index];
+    int n = get_sample_count();
+    if (along_x) {
+        int first = direction > 0 ? level.origin_x + n : level.origin_x - 1;
+        fill_column(level_index, first);
+        fill_column(level_index, first + direction);
+        level.origin_x += 2 * direction;
+    } else {
+        int first = direction > 0 ? level.origin_z + n : level.origin_z - 1;
+        fill_row(level_index, first);
+        fill_row(level_index, first + direction);
+        level.origin_z += 2 * direction;
+    }
+    level.dirty = true;
+}
+
+void HeightClipmap::follow(int level_index) {
+    // The one even origin that puts the finer window block_size - 1 or
+    // block_size cells in
+    for (int l = level_index + 1; l < (int)levels.size(); ++l) {
+        const Level& inner = levels[l - 1];
+        levels[l].target_x = floor_div(inner.origin_x / 2 - get_block_size() + 1, 2) * 2;
+        levels[l].target_z = floor_div(inner.origin_z / 2 - get_block_size() + 1, 2) * 2;
+    }
+}
+
+void HeightClipmap::fill_row(int level_index, int lattice_z) {
+    Level& level = levels[level_index];
+    int n = get_sample_count();
+    float spacing = get_spacing(level_index);
+    float* row = level.samples.data() + (size_t)wrap(lattice_z) * n;
+    for (int i = 0; i < n; ++i) {
+        int lattice_x = level.origin_x + i;
+        row[wrap(lattice_x)] = height_sampler->sample_height(lattice_x * spacing, lattice_z * spacing);
+    }
+    samples_updated += n;
+}
+
+void HeightClipmap::fill_column(int level_index, int lattice_x) {
+    Level& level = levels[level_index];
+    int n = get_sample_count();
+    float spacing = get_spacing(level_index);
+    float* column = level.samples.data() + wrap(lattice_x);
+    for (int i = 0; i < n; ++i) {
+        int lattice_z = level.origin_z + i;
+        column[(size_t)wrap(lattice_z) * n] = height_sampler->sample_height(lattice_x * spacing, lattice_z * spacing);
+    }
+    samples_updated += n;
+}
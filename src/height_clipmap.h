@@ -0,0 +1,89 @@
+//==========================================
+// height_clipmap.h - Nested toroidal height windows around the origin
+//==========================================
+#ifndef HEIGHT_CLIPMAP_H
+#define HEIGHT_CLIPMAP_H
+
+#include "height_sampler.h"
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Geometry clipmap height data. Level l samples the terrain every
+// base_spacing * 2^l world units in a window of (size + 1)^2 samples around
+// the centre. Windows are toroidal: sample (x, z) of the level's lattice lives
+// at (x mod n, z mod n), so following the centre only refreshes the rows or
+// columns that scroll in. update() does a bounded number of such lines per
+// call, finest level first, so the cost per frame does not depend on how far
+// the clipmap reaches. Each coarser level follows the one inside it rather
+// than the centre, so the finer window always starts block_size - 1 or
+// block_size cells in, which is all the renderer's fixed footprint has room
+// for. CPU only; ClipmapRenderer draws it.
+class HeightClipmap {
+public:
+    struct Level {
+        int origin_x = 0;         // Lattice index (in this level's samples) of the window's first sample
+        int origin_z = 0;
+        int target_x = 0;         // Where the window is heading
+        int target_z = 0;
+        int filled_rows = 0;      // Rows of a full refill done so far; == sample count when complete
+        bool dirty = false;       // Changed since the renderer last took it
+        std::vector<float> samples;
+    };
+
+    HeightClipmap(const HeightSampler* sampler, float base_spacing, int level_count, int size);
+
+    // Retargets every level on the world position; nothing is sampled yet
+    void set_center(float world_x, float world_z);
+
+    // Refreshes up to max_lines rows/columns; returns how many it did. A
+    // scroll moves two lines of the level and of every coarser level it would
+    // no longer nest in, so the budget is never less than two lines per level.
+    int update(int max_lines);
+
+    // Refills every level in place, e.g. after the height source changed
+    void invalidate();
+
+    bool is_settled() const;
+    int get_level_count() const { return (int)levels.size(); }
+    int get_size() const { return size; }
+    int get_sample_count() const { return size + 1; }
+    // Samples per side of the renderer's footprint blocks; size is 4 * (block_size - 1) + 2
+    int get_block_size() const { return (size + 2) / 4; }
+    float get_spacing(int level) const { return base_spacing * (float)(1 << level); }
+    const Level& get_level(int level) const { return levels[level]; }
+    bool is_level_ready(int level) const { return levels[level].filled_rows == get_sample_count(); }
+    bool take_dirty(int level);
+
+    // Whether a finer window starting at inner_origin sits where a coarser one
+    // starting at outer_origin has room for it, along one axis
+    bool is_nested(int inner_origin, int outer_origin) const;
+
+    // Sample of a level at a lattice index inside its current window
+    float get_sample(int level, int lattice_x, int lattice_z) const;
+
+    uint64_t get_lines_updated() const { return lines_updated; }
+    uint64_t get_samples_updated() const { return samples_updated; }
+
+private:
+    const HeightSampler* height_sampler;
+    float base_spacing;
+    int size;
+    std::vector<Level> levels;
+    uint64_t lines_updated = 0;
+    uint64_t samples_updated = 0;
+
+    int wrap(int lattice) const;
+    // Lines done, at most budget; 0 when nothing that fits is left to do
+    int step_level(int level_index, int budget);
+    void scroll_level(int level_index, bool along_x, int direction);
+    // Retargets every level coarser than level_index on the one inside it
+    void follow(int level_index);
+    void fill_row(int level_index, int lattice_z);
+    void fill_column(int level_index, int lattice_x);
+};
+
+}
+
+#endif
@@ -3,7 +3,9 @@
 //==========================================
 #include "height_sampler.h"
 #include "river_generator.h"
+#include "noise_sampling.h"
 #include <godot_cpp/classes/noise.hpp>
+#include <algorithm>
 #include <cmath>
 
 #ifndef M_PI
@@ -13,213 +15,405 @@
 using namespace godot;
 
 HeightSampler::HeightSampler(const TerrainConfig* terrain_config)
-    : config(terrain_config) {
+    : config(terrain_config),
+      tile_cache(terrain_config->width / (float)terrain_config->segment_count,
+                 [this](Vector2i tile_coord, HeightTileCache::Tile* tile) {
+                     generate_lattice_block(tile_coord.x * HeightTileCache::TILE_CELLS,
+                                            tile_coord.y * HeightTileCache::TILE_CELLS,
+                                            HeightTileCache::TILE_SAMPLES, HeightTileCache::TILE_SAMPLES,
+                                            tile->heights, HeightTileCache::TILE_SAMPLES);
+                 }) {
+    tile_cache.set_max_bytes((size_t)config->height_cache_size_mb * 1024 * 1024);
+}
+
+bool HeightSampler::has_noise_textures() const {
+    return !config->continentalness_texture.is_null() &&
+           !config->peaks_and_valleys_texture.is_null() &&
+           !config->erosion_texture.is_null();
+}
+
+const NativeNoiseLayers& HeightSampler::native_layers() const {
+    // Until the first snapshot is published every layer uses Godot's noise
+    static const NativeNoiseLayers none;
+    const NativeNoiseLayers* layers = config->native_noise.get();
+    return layers ? *layers : none;
+}
+
+const CurveLUTs& HeightSampler::curve_luts() const {
+    // Identity until the first bake is published
+    static const CurveLUTs identity;
+    const CurveLUTs* luts = config->curve_luts.get();
+    return luts ? *luts : identity;
+}
+
+const CarvingFalloffLUT& HeightSampler::carving_falloff() const {
+    // Default smoothness until the first bake is published
+    static const CarvingFalloffLUT default_falloff;
+    const CarvingFalloffLUT* falloff = config->carving_falloff_lut.get();
+    return falloff ? *falloff : default_falloff;
+}
+
+bool HeightSampler::has_height_source() const {
+    return config->noise_program.get() != nullptr || has_noise_textures();
 }
 
 float HeightSampler::sample_height(float world_x, float world_z) const {
-    if (config->continentalness_texture.is_null() ||
-        config->peaks_and_valleys_texture.is_null() ||
-        config->erosion_texture.is_null()) {
+    if (auto program = config->noise_program.get()) {
+        return program->execute_point(world_x, world_z) * config->height_scale;
+    }
+    if (!has_noise_textures()) {
         return 0.0f;
     }
 
     return sample_combined_noise(world_x, world_z);
 }
 
-float HeightSampler::sample_height_with_rivers(float world_x, float world_z, const std::vector<RiverSegment>& river_segments) const {
-    float base_height = sample_height(world_x, world_z);
-    
-    if (!config->enable_river_carving || river_segments.empty()) {
-        return base_height;
+float HeightSampler::sample_height_cached(float world_x, float world_z) const {
+    if (!has_height_source()) {
+        return 0.0f;
     }
-    
-    float carving_effect = calculate_river_carving_effect(world_x, world_z, river_segments);
-    return base_height - carving_effect;
+    if (tile_cache.is_enabled()) {
+        return tile_cache.sample_bilinear(world_x, world_z);
+    }
+
+    // Same lattice samples and interpolation as the cache, so river tracing
+    // does not depend on whether it is enabled
+    float inv_spacing = 1.0f / tile_cache.get_spacing();
+    float lattice_x = world_x * inv_spacing;
+    float lattice_z = world_z * inv_spacing;
+    int cell_x = (int)std::floor(lattice_x);
+    int cell_z = (int)std::floor(lattice_z);
+    float fx = lattice_x - cell_x;
+    float fz = lattice_z - cell_z;
+
+    float corners[4];
+    generate_lattice_block(cell_x, cell_z, 2, 2, corners, 2);
+    float h0 = corners[0] + fx * (corners[1] - corners[0]);
+    float h1 = corners[2] + fx * (corners[3] - corners[2]);
+    return h0 + fz * (h1 - h0);
+}
+
+float HeightSampler::sample_height_and_gradient(float world_x, float world_z, Vector2& r_gradient) const {
+    if (auto program = config->noise_program.get()) {
+        float height = program->execute_point_with_gradient(world_x, world_z, r_gradient);
+        r_gradient *= config->height_scale;
+        return height * config->height_scale;
+    }
+    if (!has_noise_textures()) {
+        r_gradient = Vector2(0.0f, 0.0f);
+        return 0.0f;
+    }
+
+    const NativeNoiseLayers& native = native_layers();
+    Vector2 continentalness_gradient, peaks_and_valleys_gradient, erosion_gradient;
+    float continentalness = sample_layer_with_gradient(native.continentalness, config->continentalness_texture,
+                                                       world_x, world_z, continentalness_gradient);
+    float peaks_and_valleys = sample_layer_with_gradient(native.peaks_and_valleys, config->peaks_and_valleys_texture,
+                                                         world_x, world_z, peaks_and_valleys_gradient);
+    float erosion = sample_layer_with_gradient(native.erosion, config->erosion_texture,
+                                               world_x, world_z, erosion_gradient);
+
+    // Same chain as combine_layers(): normalize (x0.5), curve slope, height scale
+    const CurveLUTs& luts = curve_luts();
+    float continentalness_slope, peaks_and_valleys_slope, erosion_slope;
+    continentalness = luts.continentalness.sample_with_derivative((continentalness + 1.0f) * 0.5f, continentalness_slope);
+    peaks_and_valleys = luts.peaks_and_valleys.sample_with_derivative((peaks_and_valleys + 1.0f) * 0.5f, peaks_and_valleys_slope);
+    erosion = luts.erosion.sample_with_derivative((erosion + 1.0f) * 0.5f, erosion_slope);
+
+    float gradient_scale = 0.5f * config->height_scale;
+    r_gradient = (continentalness_gradient * continentalness_slope +
+                  peaks_and_valleys_gradient * peaks_and_valleys_slope +
+                  erosion_gradient * erosion_slope) * gradient_scale;
+
+    return (continentalness + peaks_and_valleys + erosion) * config->height_scale;
+}
+
+Vector3 HeightSampler::normal_from_gradient(const Vector2& gradient) {
+    return Vector3(-gradient.x, 1.0f, -gradient.y).normalized();
 }
 
 Vector3 HeightSampler::sample_normal(float world_x, float world_z) const {
-    float step = config->width / (float)config->segment_count;
-    float height = sample_height(world_x, world_z);
-    float height_left = sample_height(world_x - step, world_z);
-    float height_right = sample_height(world_x + step, world_z);
-    float height_up = sample_height(world_x, world_z - step);
-    float height_down = sample_height(world_x, world_z + step);
+    Vector2 gradient;
+    sample_height_and_gradient(world_x, world_z, gradient);
+    return normal_from_gradient(gradient);
+}
 
-    Vector3 tangent_x = Vector3(step, height_right - height_left, 0.0f);
-    Vector3 tangent_z = Vector3(0.0f, height_down - height_up, step);
+void HeightSampler::precompute_height_data(Vector2i chunk_pos, int extended_size, PackedFloat32Array& height_data) const {
+    // The extended grid sits on the global height lattice, one sample outside the chunk on each side
+    int lattice_x = chunk_pos.x * config->segment_count - 1;
+    int lattice_z = chunk_pos.y * config->segment_count - 1;
 
-    return tangent_z.cross(tangent_x).normalized();
+    if (tile_cache.is_enabled() && has_height_source()) {
+        tile_cache.read_block(lattice_x, lattice_z, extended_size, extended_size, height_data.ptrw(), extended_size);
+    } else {
+        generate_lattice_block(lattice_x, lattice_z, extended_size, extended_size, height_data.ptrw(), extended_size);
+    }
 }
 
-void HeightSampler::precompute_height_data(Vector2i chunk_pos, float step, int extended_size, PackedFloat32Array& height_data) const {
-    float chunk_world_x = chunk_pos.x * config->width;
-    float chunk_world_z = chunk_pos.y * config->width;
+void HeightSampler::generate_lattice_block(int lattice_x, int lattice_z, int count_x, int count_z, float* out, int out_stride) const {
+    if (auto program = config->noise_program.get()) {
+        program->execute_lattice(lattice_x, lattice_z, count_x, count_z, out, out_stride);
+        for (int z = 0; z < count_z; ++z) {
+            float* row = out + z * out_stride;
+            for (int x = 0; x < count_x; ++x) {
+                row[x] *= config->height_scale;
+            }
+        }
+        return;
+    }
 
-    if (config->continentalness_texture.is_null()) {
-        for (int i = 0; i < extended_size * extended_size; ++i) {
-            height_data[i] = 0.0f;
+    if (!has_noise_textures()) {
+        for (int z = 0; z < count_z; ++z) {
+            std::fill(out + z * out_stride, out + z * out_stride + count_x, 0.0f);
         }
         return;
     }
 
-    // Generate the terrain heights
-    for (int z = -1; z <= config->segment_count + 1; ++z) {
-        float world_z = chunk_world_z + z * step;
-        int row_offset = (z + 1) * extended_size;
+    // Evaluate each layer over the whole block at its own rate, then combine
+    float spacing = tile_cache.get_spacing();
+    int count = count_x * count_z;
+    std::vector<float> continentalness(count);
+    std::vector<float> peaks_and_valleys(count);
+    std::vector<float> erosion(count);
+
+    const NativeNoiseLayers& native = native_layers();
+    sample_noise_block(native.continentalness, config->continentalness_texture->get_noise(), native.continentalness_rate, spacing,
+                       lattice_x, lattice_z, count_x, count_z, continentalness.data());
+    sample_noise_block(native.peaks_and_valleys, config->peaks_and_valleys_texture->get_noise(), native.peaks_and_valleys_rate, spacing,
+                       lattice_x, lattice_z, count_x, count_z, peaks_and_valleys.data());
+    sample_noise_block(native.erosion, config->erosion_texture->get_noise(), native.erosion_rate, spacing,
+                       lattice_x, lattice_z, count_x, count_z, erosion.data());
 
-        for (int x = -1; x <= config->segment_count + 1; ++x) {
-            float world_x = chunk_world_x + x * step;
-            float height = sample_combined_noise(world_x, world_z);
-            height_data[row_offset + (x + 1)] = height;
+    for (int z = 0; z < count_z; ++z) {
+        float* row = out + z * out_stride;
+        int offset = z * count_x;
+        for (int x = 0; x < count_x; ++x) {
+            row[x] = combine_layers(continentalness[offset + x], peaks_and_valleys[offset + x], erosion[offset + x]);
         }
     }
 }
 
 float HeightSampler::sample_combined_noise(float world_x, float world_z) const {
-    float continentalness = config->continentalness_texture->get_noise()->get_noise_2d(world_x, world_z);
-    float peaks_and_valleys = config->peaks_and_valleys_texture->get_noise()->get_noise_2d(world_x, world_z);
-    float erosion = config->erosion_texture->get_noise()->get_noise_2d(world_x, world_z);
+    const NativeNoiseLayers& native = native_layers();
+    float continentalness = sample_layer(native.continentalness, config->continentalness_texture, world_x, world_z);
+    float peaks_and_valleys = sample_layer(native.peaks_and_valleys, config->peaks_and_valleys_texture, world_x, world_z);
+    float erosion = sample_layer(native.erosion, config->erosion_texture, world_x, world_z);
+
+    return combine_layers(continentalness, peaks_and_valleys, erosion);
+}
 
+float HeightSampler::combine_layers(float continentalness, float peaks_and_valleys, float erosion) const {
     // Normalize to 0-1 range
     continentalness = (continentalness + 1.0f) * 0.5f;
     peaks_and_valleys = (peaks_and_valleys + 1.0f) * 0.5f;
     erosion = (erosion + 1.0f) * 0.5f;
 
-    // Apply curves if available
-    if (!config->continentalness_curve.is_null()) {
-        continentalness = config->continentalness_curve->sample(continentalness);
-        peaks_and_valleys = config->peaks_and_valleys_curve->sample(peaks_and_valleys);
-        erosion = config->erosion_curve->sample(erosion);
-    }
+    // Apply curves (identity when a curve is not set)
+    const CurveLUTs& luts = curve_luts();
+    continentalness = luts.continentalness.sample(continentalness);
+    peaks_and_valleys = luts.peaks_and_valleys.sample(peaks_and_valleys);
+    erosion = luts.erosion.sample(erosion);
 
     return (continentalness + peaks_and_valleys + erosion) * config->height_scale;
 }
 
-void HeightSampler::precompute_height_data_with_rivers(Vector2i chunk_pos, float step, int extended_size, 
+float HeightSampler::sample_layer(const NativeNoise& native, const Ref<NoiseTexture2D>& texture, float world_x, float world_z) const {
+    if (native.is_valid()) {
+        return native.sample(world_x, world_z);
+    }
+    return texture->get_noise()->get_noise_2d(world_x, world_z);
+}
+
+float HeightSampler::sample_layer_with_gradient(const NativeNoise& native, const Ref<NoiseTexture2D>& texture,
+                                               float world_x, float world_z, Vector2& r_gradient) const {
+    if (native.is_valid()) {
+        return native.sample_with_gradient(world_x, world_z, r_gradient.x, r_gradient.y);
+    }
+
+    // Godot's Noise has no derivative API; use central differences instead
+    const float EPSILON = 0.05f;
+    Ref<Noise> noise = texture->get_noise();
+    float value = noise->get_noise_2d(world_x, world_z);
+    float dx = noise->get_noise_2d(world_x + EPSILON, world_z) - noise->get_noise_2d(world_x - EPSILON, world_z);
+    float dz = noise->get_noise_2d(world_x, world_z + EPSILON) - noise->get_noise_2d(world_x, world_z - EPSILON);
+    r_gradient = Vector2(dx, dz) / (2.0f * EPSILON);
+    return value;
+}
+
+
+void HeightSampler::precompute_height_data_with_rivers(Vector2i chunk_pos, int extended_size, 
                                                       PackedFloat32Array& height_data, 
-                                                      const std::vector<RiverSegment>& river_segments) const {
+                                                      const RiverDistanceField& river_field) const {
+    // Generate the base terrain heights
+    precompute_height_data(chunk_pos, extended_size, height_data);
+
+    if (!has_height_source() || !config->enable_river_carving || river_field.is_empty()) {
+        return;
+    }
+
+    // The field uses the same extended grid layout, so carving is a plain per-vertex subtraction
+    for (int z = 0; z < extended_size; ++z) {
+        int row_offset = z * extended_size;
+        for (int x = 0; x < extended_size; ++x) {
+            height_data[row_offset + x] -= river_field.texel(x, z).carving;
+        }
+    }
+}
+
+void HeightSampler::build_river_distance_field(Vector2i chunk_pos, const std::vector<RiverSegment>& river_segments,
+                                               RiverDistanceField& r_field) const {
+    float step = config->width / (float)config->segment_count;
+    int extended_size = config->segment_count + 3;
     float chunk_world_x = chunk_pos.x * config->width;
     float chunk_world_z = chunk_pos.y * config->width;
 
-    if (config->continentalness_texture.is_null()) {
-        for (int i = 0; i < extended_size * extended_size; ++i) {
-            height_data[i] = 0.0f;
-        }
+    Vector2 region_min(chunk_world_x - step, chunk_world_z - step);
+    Vector2 region_max(chunk_world_x + (config->segment_count + 1) * step,
+                       chunk_world_z + (config->segment_count + 1) * step);
+
+    // Capsules must reach far enough for carving (width * multiplier) and for
+    // foliage exclusion (half width + exclusion radius). The extra two steps
+    // keep every texel around an excluded point exact for bilinear lookups;
+    // texels beyond that only ever read back as "at least max_distance".
+    float width_multiplier = std::max(config->river_carving_width_multiplier, 0.5f);
+    float max_distance = config->foliage_river_exclusion_radius + step * 2.0f;
+    r_field.reset(region_min, step, extended_size, max_distance);
+
+    RiverSegmentGrid segment_grid(river_segments, region_min, region_max, step * CARVING_GRID_CELL_VERTICES,
+                                  width_multiplier, max_distance);
+    if (segment_grid.is_empty()) {
         return;
     }
+    r_field.mark_has_rivers();
 
-    // Generate the base terrain heights
-    for (int z = -1; z <= config->segment_count + 1; ++z) {
-        float world_z = chunk_world_z + z * step;
-        int row_offset = (z + 1) * extended_size;
-
-        for (int x = -1; x <= config->segment_count + 1; ++x) {
-            float world_x = chunk_world_x + x * step;
-            float base_height = sample_combined_noise(world_x, world_z);
-            
-            // Apply river carving if enabled
-            float final_height = base_height;
-            if (config->enable_river_carving && !river_segments.empty()) {
-                float carving_effect = calculate_river_carving_effect(world_x, world_z, river_segments);
-                final_height = base_height - carving_effect;
+    // Keep nearby segments for exact queries just outside the rasterized area
+    float outside_margin = config->width * 0.5f + max_distance;
+    for (const RiverSegment& segment : river_segments) {
+        float reach = segment.width * 0.5f + outside_margin;
+        if (std::max(segment.start.x, segment.end.x) + reach >= region_min.x &&
+            std::min(segment.start.x, segment.end.x) - reach <= region_max.x &&
+            std::max(segment.start.y, segment.end.y) + reach >= region_min.y &&
+            std::min(segment.start.y, segment.end.y) - reach <= region_max.y) {
+            r_field.add_segment(segment);
+        }
+    }
+
+    bool carve = config->enable_river_carving;
+    // One table for the whole field, even if a new one is published meanwhile
+    const CarvingFalloffLUT& falloff = carving_falloff();
+    for (int z = 0; z < extended_size; ++z) {
+        float world_z = region_min.y + z * step;
+
+        for (int x = 0; x < extended_size; ++x) {
+            float world_x = region_min.x + x * step;
+            Vector2 point(world_x, world_z);
+
+            const uint32_t* candidate;
+            const uint32_t* candidates_end;
+            segment_grid.query(world_x, world_z, candidate, candidates_end);
+
+            RiverDistanceField::Texel& texel = r_field.texel(x, z);
+            float total_carving = 0.0f;
+
+            for (; candidate != candidates_end; ++candidate) {
+                const RiverSegment& segment = river_segments[*candidate];
+
+                // Calculate distance from point to line segment
+                Vector2 segment_vec = segment.end - segment.start;
+                float segment_length_sq = segment_vec.length_squared();
+                bool degenerate = segment_length_sq < 0.0001f;
+
+                float t = 0.0f;
+                float distance;
+                if (degenerate) {
+                    // Degenerate segment, treat as point
+                    distance = point.distance_to(segment.start);
+                } else {
+                    // Project point onto line segment
+                    Vector2 point_vec = point - segment.start;
+                    t = std::max(0.0f, std::min(1.0f, point_vec.dot(segment_vec) / segment_length_sq));
+                    distance = point.distance_to(segment.start + t * segment_vec);
+                }
+
+                if (distance < texel.distance) {
+                    texel.distance = distance;
+                    texel.width = segment.width;
+                    texel.t = t;
+                }
+                texel.bank_distance = std::min(texel.bank_distance, distance - segment.width * 0.5f);
+
+                if (carve) {
+                    // Additive blending for overlapping rivers
+                    total_carving += calculate_segment_carving(segment, distance, t, degenerate, falloff);
+                }
             }
-            
-            height_data[row_offset + (x + 1)] = final_height;
+
+            // Apply a soft maximum to prevent excessive carving from overlapping rivers
+            // This uses a smooth saturation function instead of a hard max
+            float max_allowed_carving = config->river_carving_depth * 2.0f; // Allow up to 2x the base depth
+            texel.carving = max_allowed_carving * (total_carving / (total_carving + max_allowed_carving));
         }
     }
 }
 
-float HeightSampler::calculate_river_carving_effect(float world_x, float world_z, 
-                                                   const std::vector<RiverSegment>& river_segments) const {
-    float total_carving = 0.0f;
-    
-    for (const RiverSegment& segment : river_segments) {
-        // Calculate distance from point to line segment
-        Vector2 point(world_x, world_z);
-        Vector2 line_start = segment.start;
-        Vector2 line_end = segment.end;
+float HeightSampler::calculate_segment_carving(const RiverSegment& segment, float distance, float t, bool degenerate,
+                                               const CarvingFalloffLUT& falloff) const {
+    if (degenerate) {
+        float carving = smooth_carving_falloff(distance, segment.width, falloff);
         
-        // Vector from start to end of segment
-        Vector2 segment_vec = line_end - line_start;
-        float segment_length_sq = segment_vec.length_squared();
-        
-        if (segment_length_sq < 0.0001f) {
-            // Degenerate segment, treat as point
-            float distance = point.distance_to(line_start);
-            float carving = smooth_carving_falloff(distance, segment.width);
-            
-            // Calculate depth for this segment with progressive uphill compensation
-            float river_depth = config->river_carving_depth;
-            if (segment.uphill_amount > 0.0f) {
-                // For point segments, apply maximum compensation since we can't interpolate
-                float base_compensation = (segment.uphill_amount / config->height_scale) * config->river_uphill_carving_multiplier;
-                float progressive_multiplier = 1.0f + base_compensation; // Full compensation for point sources
-                river_depth *= progressive_multiplier;
-                river_depth = std::min(river_depth, config->river_carving_depth * 5.0f);
-            }
-            
-            carving *= river_depth;
-            
-            // Add to total (rivers can overlap and combine their effects)
-            total_carving += carving;
-            continue;
+        // Calculate depth for this segment with progressive uphill compensation
+        float river_depth = config->river_carving_depth;
+        if (segment.uphill_amount > 0.0f) {
+            // For point segments, apply maximum compensation since we can't interpolate
+            float base_compensation = (segment.uphill_amount / config->height_scale) * config->river_uphill_carving_multiplier;
+            float progressive_multiplier = 1.0f + base_compensation; // Full compensation for point sources
+            river_depth *= progressive_multiplier;
+            river_depth = std::min(river_depth, config->river_carving_depth * 5.0f);
         }
         
-        // Project point onto line segment
-        Vector2 point_vec = point - line_start;
-        float t = std::max(0.0f, std::min(1.0f, point_vec.dot(segment_vec) / segment_length_sq));
+        return carving * river_depth;
+    }
+
+    // Calculate carving effect based on distance and river properties
+    float carving = smooth_carving_falloff(distance, segment.width, falloff);
+    
+    if (carving <= 0.0f) {  // Only process if there's an effect
+        return 0.0f;
+    }
+
+    // Base river depth
+    float river_depth = config->river_carving_depth;
+    
+    // Interpolate depth based on height difference along the river
+    if (segment.start_height != segment.end_height) {
+        float height_at_point = segment.start_height + t * (segment.end_height - segment.start_height);
+        // Deeper carving at lower elevations (rivers get deeper as they flow down)
+        river_depth *= (1.0f + 0.5f * (segment.start_height - height_at_point) / config->height_scale);
+        river_depth = std::max(0.1f, river_depth); // Minimum depth
+    }
+    
+    // Progressive uphill carving compensation - carve more at higher elevations
+    if (segment.uphill_amount > 0.0f) {
+        // For uphill segments, apply stronger carving toward the end (higher elevation)
+        // t=0 is start (lower), t=1 is end (higher)
+        float uphill_progress = t; // How far along the uphill segment we are
         
-        // Find closest point on segment
-        Vector2 closest_point = line_start + t * segment_vec;
-        float distance = point.distance_to(closest_point);
+        // Calculate base compensation
+        float base_compensation = (segment.uphill_amount / config->height_scale) * config->river_uphill_carving_multiplier;
         
-        // Calculate carving effect based on distance and river properties
-        float carving = smooth_carving_falloff(distance, segment.width);
+        // Apply progressive scaling - more carving at higher elevations
+        // Use quadratic scaling to concentrate carving at the peak
+        float progressive_multiplier = 1.0f + base_compensation * (0.3f + 0.7f * uphill_progress * uphill_progress);
         
-        if (carving > 0.0f) {  // Only process if there's an effect
-            // Base river depth
-            float river_depth = config->river_carving_depth;
-            
-            // Interpolate depth based on height difference along the river
-            if (segment.start_height != segment.end_height) {
-                float height_at_point = segment.start_height + t * (segment.end_height - segment.start_height);
-                // Deeper carving at lower elevations (rivers get deeper as they flow down)
-                river_depth *= (1.0f + 0.5f * (segment.start_height - height_at_point) / config->height_scale);
-                river_depth = std::max(0.1f, river_depth); // Minimum depth
-            }
-            
-            // Progressive uphill carving compensation - carve more at higher elevations
-            if (segment.uphill_amount > 0.0f) {
-                // For uphill segments, apply stronger carving toward the end (higher elevation)
-                // t=0 is start (lower), t=1 is end (higher)
-                float uphill_progress = t; // How far along the uphill segment we are
-                
-                // Calculate base compensation
-                float base_compensation = (segment.uphill_amount / config->height_scale) * config->river_uphill_carving_multiplier;
-                
-                // Apply progressive scaling - more carving at higher elevations
-                // Use quadratic scaling to concentrate carving at the peak
-                float progressive_multiplier = 1.0f + base_compensation * (0.3f + 0.7f * uphill_progress * uphill_progress);
-                
-                river_depth *= progressive_multiplier;
-                // Cap the maximum compensation to prevent excessive carving
-                river_depth = std::min(river_depth, config->river_carving_depth * 5.0f);
-            }
-            
-            carving *= river_depth;
-            
-            // Add to total carving (additive blending for overlapping rivers)
-            total_carving += carving;
-        }
+        river_depth *= progressive_multiplier;
+        // Cap the maximum compensation to prevent excessive carving
+        river_depth = std::min(river_depth, config->river_carving_depth * 5.0f);
     }
     
-    // Apply a soft maximum to prevent excessive carving from overlapping rivers
-    // This uses a smooth saturation function instead of a hard max
-    float max_allowed_carving = config->river_carving_depth * 2.0f; // Allow up to 2x the base depth
-    return max_allowed_carving * (total_carving / (total_carving + max_allowed_carving));
+    return carving * river_depth;
 }
 
-float HeightSampler::smooth_carving_falloff(float distance, float river_width) const {
+float HeightSampler::smooth_carving_falloff(float distance, float river_width, const CarvingFalloffLUT& falloff) const {
     // Calculate the effective carving radius
     float carving_radius = river_width * config->river_carving_width_multiplier;
     
@@ -227,20 +421,6 @@ float HeightSampler::smooth_carving_falloff(float distance, float river_width) c
         return 0.0f; // No effect outside the carving radius
     }
     
-    // Normalize distance to 0-1 range
-    float normalized_distance = distance / carving_radius;
-    
-    // Create smooth falloff using a combination of cosine and exponential curves
-    // This creates a natural-looking river bed shape
-    float cosine_falloff = 0.5f * (1.0f + std::cos(normalized_distance * M_PI));
-    
-    // Apply smoothness parameter - higher values create smoother transitions
-    float smoothness = config->river_carving_smoothness;
-    float smooth_falloff = std::pow(cosine_falloff, smoothness);
-    
-    // Add a slight exponential decay for more natural looking banks
-    float exp_factor = std::exp(-normalized_distance * 2.0f);
-    
-    // Blend the two falloff curves
-    return smooth_falloff * (0.7f + 0.3f * exp_factor);
+    // Cosine/exponential river bed profile, baked for the current smoothness
+    return falloff.sample(distance / carving_radius);
 }
\ No newline at end of file
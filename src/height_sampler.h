@@ -5,7 +5,12 @@
 #define HEIGHT_SAMPLER_H
 
 #include "terrain_config.h"
+#include "height_tile_cache.h"
+#include "river_segment_grid.h"
+#include "river_distance_field.h"
 #include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <atomic>
 #include <vector>
 
 namespace godot {
@@ -16,25 +21,57 @@ struct RiverSegment;
 class HeightSampler {
 private:
     const TerrainConfig* config;
+    mutable HeightTileCache tile_cache;
+    mutable std::atomic<uint32_t> generation{0};
+
+    static constexpr int CARVING_GRID_CELL_VERTICES = 4;  // Carving index cell size, in grid steps
 
 public:
     HeightSampler(const TerrainConfig* terrain_config);
 
     float sample_height(float world_x, float world_z) const;
-    float sample_height_with_rivers(float world_x, float world_z, const std::vector<RiverSegment>& river_segments) const;
+    // Bilinear lookup between lattice samples, through the shared height tile
+    // cache when it is enabled; the result is the same either way
+    float sample_height_cached(float world_x, float world_z) const;
+    // Height plus its partial derivatives (dh/dx, dh/dz) from a single evaluation
+    float sample_height_and_gradient(float world_x, float world_z, Vector2& r_gradient) const;
+    static Vector3 normal_from_gradient(const Vector2& gradient);
     Vector3 sample_normal(float world_x, float world_z) const;
-    void precompute_height_data(Vector2i chunk_pos, float step, int extended_size, PackedFloat32Array& height_data) const;
+    void precompute_height_data(Vector2i chunk_pos, int extended_size, PackedFloat32Array& height_data) const;
     
     // River carving methods
-    void precompute_height_data_with_rivers(Vector2i chunk_pos, float step, int extended_size, 
+    // Rasterize nearest-river data and carving depth over the chunk's extended grid
+    void build_river_distance_field(Vector2i chunk_pos, const std::vector<RiverSegment>& river_segments,
+                                    RiverDistanceField& r_field) const;
+    void precompute_height_data_with_rivers(Vector2i chunk_pos, int extended_size, 
                                            PackedFloat32Array& height_data, 
-                                           const std::vector<RiverSegment>& river_segments) const;
+                                           const RiverDistanceField& river_field) const;
+
+    // Height tile cache control; must be cleared whenever noise, curves or height scale change.
+    // Each clear bumps the generation, so other height copies (the clipmap) can tell they are stale.
+    void clear_cache() const {
+        tile_cache.clear();
+        generation.fetch_add(1);
+    }
+    uint32_t get_generation() const { return generation.load(); }
+    void set_cache_size(size_t bytes) const { tile_cache.set_max_bytes(bytes); }
+    Dictionary get_cache_stats() const { return tile_cache.get_stats(); }
 
 private:
+    bool has_noise_textures() const;
+    bool has_height_source() const;
+    const NativeNoiseLayers& native_layers() const;
+    const CurveLUTs& curve_luts() const;
+    const CarvingFalloffLUT& carving_falloff() const;
+    void generate_lattice_block(int lattice_x, int lattice_z, int count_x, int count_z, float* out, int out_stride) const;
     float sample_combined_noise(float world_x, float world_z) const;
-    float calculate_river_carving_effect(float world_x, float world_z, 
-                                       const std::vector<RiverSegment>& river_segments) const;
-    float smooth_carving_falloff(float distance, float river_width) const;
+    float combine_layers(float continentalness, float peaks_and_valleys, float erosion) const;
+    float sample_layer(const NativeNoise& native, const Ref<NoiseTexture2D>& texture, float world_x, float world_z) const;
+    float sample_layer_with_gradient(const NativeNoise& native, const Ref<NoiseTexture2D>& texture,
+                                     float world_x, float world_z, Vector2& r_gradient) const;
+    float calculate_segment_carving(const RiverSegment& segment, float distance, float t, bool degenerate,
+                                    const CarvingFalloffLUT& falloff) const;
+    float smooth_carving_falloff(float distance, float river_width, const CarvingFalloffLUT& falloff) const;
 };
 
 }
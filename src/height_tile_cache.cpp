@@ -0,0 +1,140 @@
+//==========================================
+// height_tile_cache.cpp
+//==========================================
+#include "height_tile_cache.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+HeightTileCache::HeightTileCache(float lattice_spacing, TileGenerator generator)
+    : spacing(lattice_spacing), inv_spacing(1.0f / lattice_spacing), generate_tile(std::move(generator)) {
+}
+
+void HeightTileCache::set_max_bytes(size_t p_max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_tiles.store(p_max_bytes / sizeof(Tile));
+    evict_to_capacity();
+}
+
+std::shared_ptr<const HeightTileCache::Tile> HeightTileCache::get_tile(Vector2i tile_coord) {
+    uint64_t generation_epoch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = tiles.find(tile_coord);
+        if (it != tiles.end()) {
+            lru.splice(lru.begin(), lru, it->second.lru_position);
+            hits++;
+            return it->second.tile;
+        }
+        misses++;
+        generation_epoch = epoch;
+    }
+
+    // Generate outside the lock so other threads keep reading resident tiles
+    auto tile = std::make_shared<Tile>();
+    generate_tile(tile_coord, tile.get());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (max_tiles.load() == 0 || generation_epoch != epoch) {
+        return tile;
+    }
+
+    // Another thread may have produced the same tile meanwhile; keep theirs
+    auto it = tiles.find(tile_coord);
+    if (it != tiles.end()) {
+        lru.splice(lru.begin(), lru, it->second.lru_position);
+        return it->second.tile;
+    }
+
+    lru.push_front(tile_coord);
+    tiles.emplace(tile_coord, Entry{tile, lru.begin()});
+    evict_to_capacity();
+    return tile;
+}
+
+void HeightTileCache::evict_to_capacity() {
+    while (tiles.size() > max_tiles.load()) {
+        tiles.erase(lru.back());
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+float HeightTileCache::sample_lattice(int lattice_x, int lattice_z) {
+    int tile_x = floor_div(lattice_x, TILE_CELLS);
+    int tile_z = floor_div(lattice_z, TILE_CELLS);
+    auto tile = get_tile(Vector2i(tile_x, tile_z));
+
+    int local_x = lattice_x - tile_x * TILE_CELLS;
+    int local_z = lattice_z - tile_z * TILE_CELLS;
+    return tile->heights[local_z * TILE_SAMPLES + local_x];
+}
+
+float HeightTileCache::sample_bilinear(float world_x, float world_z) {
+    float lattice_x = world_x * inv_spacing;
+    float lattice_z = world_z * inv_spacing;
+    int cell_x = (int)std::floor(lattice_x);
+    int cell_z = (int)std::floor(lattice_z);
+    float fx = lattice_x - cell_x;
+    float fz = lattice_z - cell_z;
+
+    // Tiles overlap by one sample, so the whole cell lives in a single tile
+    int tile_x = floor_div(cell_x, TILE_CELLS);
+    int tile_z = floor_div(cell_z, TILE_CELLS);
+    auto tile = get_tile(Vector2i(tile_x, tile_z));
+
+    int local_x = cell_x - tile_x * TILE_CELLS;
+    int local_z = cell_z - tile_z * TILE_CELLS;
+    const float* row0 = tile->heights + local_z * TILE_SAMPLES + local_x;
+    const float* row1 = row0 + TILE_SAMPLES;
+
+    float h0 = row0[0] + fx * (row0[1] - row0[0]);
+    float h1 = row1[0] + fx * (row1[1] - row1[0]);
+    return h0 + fz * (h1 - h0);
+}
+
+void HeightTileCache::read_block(int lattice_x, int lattice_z, int count_x, int count_z, float* out, int out_stride) {
+    int first_tile_x = floor_div(lattice_x, TILE_CELLS);
+    int first_tile_z = floor_div(lattice_z, TILE_CELLS);
+    int last_tile_x = floor_div(lattice_x + count_x - 1, TILE_CELLS);
+    int last_tile_z = floor_div(lattice_z + count_z - 1, TILE_CELLS);
+
+    for (int tile_z = first_tile_z; tile_z <= last_tile_z; ++tile_z) {
+        for (int tile_x = first_tile_x; tile_x <= last_tile_x; ++tile_x) {
+            auto tile = get_tile(Vector2i(tile_x, tile_z));
+
+            // Intersection of the requested block with this tile's own cells
+            int begin_x = std::max(lattice_x, tile_x * TILE_CELLS);
+            int end_x = std::min(lattice_x + count_x, (tile_x + 1) * TILE_CELLS);
+            int begin_z = std::max(lattice_z, tile_z * TILE_CELLS);
+            int end_z = std::min(lattice_z + count_z, (tile_z + 1) * TILE_CELLS);
+
+            for (int z = begin_z; z < end_z; ++z) {
+                const float* src = tile->heights + (z - tile_z * TILE_CELLS) * TILE_SAMPLES + (begin_x - tile_x * TILE_CELLS);
+                float* dst = out + (z - lattice_z) * out_stride + (begin_x - lattice_x);
+                std::copy(src, src + (end_x - begin_x), dst);
+            }
+        }
+    }
+}
+
+void HeightTileCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    tiles.clear();
+    lru.clear();
+    epoch++;
+}
+
+Dictionary HeightTileCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Dictionary stats;
+    stats["hits"] = (int64_t)hits;
+    stats["misses"] = (int64_t)misses;
+    stats["evictions"] = (int64_t)evictions;
+    stats["tiles"] = (int64_t)tiles.size();
+    stats["bytes"] = (int64_t)(tiles.size() * sizeof(Tile));
+    stats["capacity_tiles"] = (int64_t)max_tiles.load();
+    return stats;
+}
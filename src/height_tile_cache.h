@@ -0,0 +1,77 @@
+//==========================================
+// height_tile_cache.h - Shared LRU cache of heightfield tiles
+//==========================================
+#ifndef HEIGHT_TILE_CACHE_H
+#define HEIGHT_TILE_CACHE_H
+
+#include "terrain_config.h"
+#include <godot_cpp/variant/dictionary.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace godot {
+
+// Heights sampled on a fixed world-space lattice (lattice index * spacing),
+// grouped into square tiles and kept in a memory-bounded LRU. Mesh generation,
+// river tracing and foliage placement all read through the same cache, so a
+// world position is only evaluated once while its tile stays resident.
+class HeightTileCache {
+public:
+    static constexpr int TILE_CELLS = 32;               // Lattice cells per tile side
+    static constexpr int TILE_SAMPLES = TILE_CELLS + 1; // Samples per side (shares one edge with the next tile)
+
+    struct Tile {
+        float heights[TILE_SAMPLES * TILE_SAMPLES];
+    };
+
+    // Fills `tile->heights` for the tile whose first lattice sample is
+    // (tile_coord * TILE_CELLS). Called without the cache lock held.
+    using TileGenerator = std::function<void(Vector2i tile_coord, Tile* tile)>;
+
+    HeightTileCache(float lattice_spacing, TileGenerator generator);
+
+    void set_max_bytes(size_t p_max_bytes);
+    bool is_enabled() const { return max_tiles.load(std::memory_order_relaxed) > 0; }
+    float get_spacing() const { return spacing; }
+
+    // Exact lattice sample
+    float sample_lattice(int lattice_x, int lattice_z);
+    // Bilinear interpolation between the lattice samples around a world position
+    float sample_bilinear(float world_x, float world_z);
+    // Copy a block of lattice samples starting at (lattice_x, lattice_z) into `out`
+    void read_block(int lattice_x, int lattice_z, int count_x, int count_z, float* out, int out_stride);
+
+    void clear();
+    Dictionary get_stats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const Tile> tile;
+        std::list<Vector2i>::iterator lru_position;
+    };
+
+    const float spacing;
+    const float inv_spacing;
+    TileGenerator generate_tile;
+    std::atomic<size_t> max_tiles{0};  // Written under the lock; is_enabled() reads it without
+
+    mutable std::mutex mutex;
+    std::unordered_map<Vector2i, Entry, Vector2iHash> tiles;
+    std::list<Vector2i> lru; // Front = most recently used
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t epoch = 0; // Bumped by clear() so tiles generated from stale inputs are dropped
+
+    std::shared_ptr<const Tile> get_tile(Vector2i tile_coord);
+    void evict_to_capacity();
+};
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+//==========================================
+// height_tiles.cpp
+//==========================================
+#include "height_tiles.h"
+#include <algorithm>
+
+using namespace godot;
+
+HeightTile HeightTile::from_grid(const float* grid, int size) {
+    HeightTile tile;
+    tile.size = size;
+    tile.heights.assign(grid, grid + (size_t)size * size);
+    auto range = std::minmax_element(tile.heights.begin(), tile.heights.end());
+    tile.min_height = *range.first;
+    tile.max_height = *range.second;
+    return tile;
+}
+
+HeightTileSet::HeightTileSet(int initial_capacity)
+    : capacity(std::max(initial_capacity, 1)) {
+    add_free_layers(0, capacity);
+}
+
+void HeightTileSet::queue(Vector2i chunk_pos, HeightTile tile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.insert_or_assign(chunk_pos, std::move(tile));
+}
+
+std::optional<HeightTileSet::Placement> HeightTileSet::place(Vector2i chunk_pos, HeightTile& r_tile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = queued.find(chunk_pos);
+    if (it == queued.end()) {
+        return std::nullopt;
+    }
+    r_tile = std::move(it->second);
+    queued.erase(it);
+
+    // A reloaded chunk overwrites the layer it already has
+    auto resident = layers.find(chunk_pos);
+    if (resident != layers.end()) {
+        return Placement{resident->second, false};
+    }
+
+    bool grown = false;
+    if (free_layers.empty()) {
+        add_free_layers(capacity, capacity * 2);
+        capacity *= 2;
+        grown = true;
+    }
+    int layer = free_layers.back();
+    free_layers.pop_back();
+    layers.emplace(chunk_pos, layer);
+    return Placement{layer, grown};
+}
+
+void HeightTileSet::release(Vector2i chunk_pos) {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.erase(chunk_pos);
+    auto it = layers.find(chunk_pos);
+    if (it != layers.end()) {
+        free_layers.push_back(it->second);
+        layers.erase(it);
+    }
+}
+
+void HeightTileSet::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.clear();
+    layers.clear();
+    free_layers.clear();
+    add_free_layers(0, capacity);
+}
+
+int HeightTileSet::get_capacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+int HeightTileSet::get_layer(Vector2i chunk_pos) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = layers.find(chunk_pos);
+    return it != layers.end() ? it->second : -1;
+}
+
+size_t HeightTileSet::get_queued_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued.size();
+}
+
+size_t HeightTileSet::get_resident_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return layers.size();
+}
+
+void HeightTileSet::add_free_layers(int from, int to) {
+    // Highest first, so low layers are handed out first
+    for (int layer = to - 1; layer >= from; --layer) {
+        free_layers.push_back(layer);
+    }
+}
@@ -0,0 +1,66 @@
+//==========================================
+// height_tiles.h - Per-chunk height tiles for GPU-displaced rendering
+//==========================================
+#ifndef HEIGHT_TILES_H
+#define HEIGHT_TILES_H
+
+#include "terrain_config.h"
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+// Heights of a chunk's extended grid, i.e. its vertices plus a one-sample
+// ring that the vertex shader reads for central-difference normals
+struct HeightTile {
+    int size = 0;                 // Texels per side: segment_count + 3
+    std::vector<float> heights;   // size * size, row-major
+    float min_height = 0.0f;
+    float max_height = 0.0f;
+
+    static HeightTile from_grid(const float* grid, int size);
+};
+
+// Tiles waiting to be uploaded, and the texture-array layer each resident
+// tile occupies. Only bookkeeping, no renderer calls, so it runs headless.
+// Loader threads queue tiles; the main thread places them when their chunk
+// enters the scene and releases them when it leaves.
+class HeightTileSet {
+public:
+    struct Placement {
+        int layer;
+        bool grown;               // Capacity doubled; every layer must be re-created
+    };
+
+    explicit HeightTileSet(int initial_capacity);
+
+    // Any thread; replaces a tile still queued for the same chunk
+    void queue(Vector2i chunk_pos, HeightTile tile);
+
+    // Moves the queued tile of chunk_pos into r_tile and gives it a layer.
+    // Returns nothing when no tile is queued for the chunk.
+    std::optional<Placement> place(Vector2i chunk_pos, HeightTile& r_tile);
+
+    void release(Vector2i chunk_pos);
+    void clear();
+
+    int get_capacity() const;
+    int get_layer(Vector2i chunk_pos) const; // -1 when not resident
+    size_t get_queued_count() const;
+    size_t get_resident_count() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<Vector2i, HeightTile, Vector2iHash> queued;
+    std::unordered_map<Vector2i, int, Vector2iHash> layers;
+    std::vector<int> free_layers;
+    int capacity;
+
+    void add_free_layers(int from, int to);
+};
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+//==========================================
+// heightfield_simplifier.cpp
+//==========================================
+#include "heightfield_simplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace godot;
+
+namespace {
+
+// Right isosceles triangle; the split vertex is the midpoint of v0-v1
+struct Triangle {
+    int a;
+    int v0;
+    int v1;
+};
+
+struct Grid {
+    const float* heights;
+    int vertices_per_row;
+
+    int x(int vertex) const { return vertex % vertices_per_row; }
+    int z(int vertex) const { return vertex / vertices_per_row; }
+
+    // Midpoint of two vertices, or -1 when it falls between lattice points
+    int midpoint(int p, int q) const {
+        int sx = x(p) + x(q);
+        int sz = z(p) + z(q);
+        if ((sx | sz) & 1) {
+            return -1;
+        }
+        return (sz / 2) * vertices_per_row + sx / 2;
+    }
+
+    // Largest vertical distance between the grid samples covered by the
+    // triangle and the triangle's plane
+    float planar_error(const Triangle& t) const {
+        int ax = x(t.a), az = z(t.a);
+        int bx = x(t.v0), bz = z(t.v0);
+        int cx = x(t.v1), cz = z(t.v1);
+        int area = (bx - ax) * (cz - az) - (bz - az) * (cx - ax);
+        if (area == 0) {
+            return 0.0f;
+        }
+        float inv_area = 1.0f / area;
+        float ha = heights[t.a], hb = heights[t.v0], hc = heights[t.v1];
+
+        float error = 0.0f;
+        for (int pz = std::min({az, bz, cz}); pz <= std::max({az, bz, cz}); ++pz) {
+            for (int px = std::min({ax, bx, cx}); px <= std::max({ax, bx, cx}); ++px) {
+                // Edge functions, each proportional to the opposite vertex's weight
+                int wa = (cx - bx) * (pz - bz) - (cz - bz) * (px - bx);
+                int wb = (ax - cx) * (pz - cz) - (az - cz) * (px - cx);
+                int wc = (bx - ax) * (pz - az) - (bz - az) * (px - ax);
+                if ((wa | wb | wc) < 0) {
+                    continue;
+                }
+                float plane = (wa * ha + wb * hb + wc * hc) * inv_area;
+                error = std::max(error, std::abs(heights[pz * vertices_per_row + px] - plane));
+            }
+        }
+        return error;
+    }
+};
+
+}
+
+bool godot::simplify_height_grid(const float* heights, int segments, float tolerance, std::vector<int32_t>& indices) {
+    indices.clear();
+    int block = segments & -segments; // Largest power of two dividing segments
+    if (block < 2) {
+        return false;
+    }
+
+    int vertices_per_row = segments + 1;
+    Grid grid = {heights, vertices_per_row};
+
+    // Two root triangles per block, split along the (0,0)-(1,1) diagonal
+    std::vector<Triangle> roots;
+    for (int z0 = 0; z0 < segments; z0 += block) {
+        for (int x0 = 0; x0 < segments; x0 += block) {
+            int c00 = z0 * vertices_per_row + x0;
+            int c10 = c00 + block;
+            int c01 = c00 + block * vertices_per_row;
+            int c11 = c01 + block;
+            roots.push_back({c10, c11, c00});
+            roots.push_back({c01, c00, c11});
+        }
+    }
+
+    // Every splittable triangle, grouped by depth. Each vertex is the split
+    // vertex of exactly one diamond (two triangles at the same depth, one on
+    // the chunk border).
+    std::vector<std::vector<Triangle>> depths;
+    std::vector<Triangle> current = roots;
+    while (!current.empty()) {
+        std::vector<Triangle> next;
+        for (const Triangle& t : current) {
+            int m = grid.midpoint(t.v0, t.v1);
+            if (m < 0) {
+                continue;
+            }
+            next.push_back({m, t.a, t.v0});
+            next.push_back({m, t.v1, t.a});
+        }
+        depths.push_back(std::move(current));
+        current = std::move(next);
+    }
+
+    // Own error of each split vertex, then saturate bottom-up so a vertex
+    // is only active if everything it depends on is active too
+    const float FORCED = std::numeric_limits<float>::infinity();
+    std::vector<float> error(vertices_per_row * vertices_per_row, 0.0f);
+    for (const std::vector<Triangle>& level : depths) {
+        for (const Triangle& t : level) {
+            int m = grid.midpoint(t.v0, t.v1);
+            if (m >= 0) {
+                error[m] = std::max(error[m], grid.planar_error(t));
+            }
+        }
+    }
+    for (int i = 0; i < vertices_per_row; ++i) {
+        error[i] = FORCED;
+        error[segments * vertices_per_row + i] = FORCED;
+        error[i * vertices_per_row] = FORCED;
+        error[i * vertices_per_row + segments] = FORCED;
+    }
+    for (int d = (int)depths.size() - 1; d >= 0; --d) {
+        for (const Triangle& t : depths[d]) {
+            int m = grid.midpoint(t.v0, t.v1);
+            if (m < 0) {
+                continue;
+            }
+            int left = grid.midpoint(t.a, t.v0);
+            int right = grid.midpoint(t.a, t.v1);
+            if (left >= 0) {
+                error[m] = std::max(error[m], error[left]);
+            }
+            if (right >= 0) {
+                error[m] = std::max(error[m], error[right]);
+            }
+        }
+    }
+
+    // Emit leaves: descend while the split vertex is active
+    std::vector<Triangle> stack(roots.rbegin(), roots.rend());
+    while (!stack.empty()) {
+        Triangle t = stack.back();
+        stack.pop_back();
+
+        int m = grid.midpoint(t.v0, t.v1);
+        if (m >= 0 && error[m] > tolerance) {
+            stack.push_back({m, t.v1, t.a});
+            stack.push_back({m, t.a, t.v0});
+        } else {
+            indices.push_back(t.a);
+            indices.push_back(t.v0);
+            indices.push_back(t.v1);
+        }
+    }
+    return true;
+}
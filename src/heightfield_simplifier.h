@@ -0,0 +1,27 @@
+//==========================================
+// heightfield_simplifier.h - Error-bounded triangulation of a height grid
+//==========================================
+#ifndef HEIGHTFIELD_SIMPLIFIER_H
+#define HEIGHTFIELD_SIMPLIFIER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Triangulates a (segments + 1)^2 row-major height grid with a restricted
+// 4-8 (longest-edge bisection) hierarchy: a vertex is kept when removing it
+// would move any grid sample under its diamond by more than `tolerance`,
+// with errors saturated up the hierarchy so the mesh never has T-junctions.
+// Every border vertex is kept, so the chunk edge is identical to the full
+// grid's and to its neighbours' whatever they decide inside.
+//
+// The hierarchy is rooted at square blocks of the largest power of two that
+// divides segments; returns false (leaving indices empty) for odd segment
+// counts, where there is nothing to gain. Triangles use the same winding as
+// the full grid.
+bool simplify_height_grid(const float* heights, int segments, float tolerance, std::vector<int32_t>& indices);
+
+}
+
+#endif
@@ -0,0 +1,218 @@
+//==========================================
+// heightmap_renderer.cpp
+//==========================================
+#include "heightmap_renderer.h"
+#include "chunk_index_buffers.h"
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cstring>
+
+using namespace godot;
+
+namespace {
+
+// Room for every chunk inside the view circle twice over, so the array only
+// grows when chunks outside it linger during fast travel
+int initial_tile_capacity(int view_distance) {
+    int count = 0;
+    for (int z = -view_distance; z <= view_distance; ++z) {
+        for (int x = -view_distance; x <= view_distance; ++x) {
+            if (x * x + z * z <= view_distance * view_distance) {
+                ++count;
+            }
+        }
+    }
+    return count * 2;
+}
+
+}
+
+HeightmapRenderer::HeightmapRenderer(const TerrainConfig* terrain_config, const HeightSampler* sampler)
+    : config(terrain_config), height_sampler(sampler), tiles(initial_tile_capacity(terrain_config->view_distance)) {
+}
+
+MeshInstance3D* HeightmapRenderer::generate_chunk(Vector2i position, const RiverDistanceField& river_field, const ChunkLod& lod,
+                                                  MeshInstance3D* recycled) {
+    int extended_size = config->segment_count + 3;
+
+    // Same extended grid the mesh path builds; the shader reads the ring for normals
+    PackedFloat32Array height_data;
+    height_data.resize(extended_size * extended_size);
+    if (river_field.is_empty()) {
+        height_sampler->precompute_height_data(position, extended_size, height_data);
+    } else {
+        height_sampler->precompute_height_data_with_rivers(position, extended_size, height_data, river_field);
+    }
+    HeightTile tile = HeightTile::from_grid(height_data.ptr(), extended_size);
+
+    MeshInstance3D* chunk_mesh = recycled ? recycled : memnew(MeshInstance3D);
+    chunk_mesh->set_position(Vector3(position.x * config->width, 0, position.y * config->width));
+
+    if (config->skip_underwater_chunks && tile.max_height < config->sea_level) {
+        chunk_mesh->set_mesh(Ref<Mesh>());
+        return chunk_mesh;
+    }
+
+    // The grid mesh is flat, so culling needs the displaced bounds
+    float width = (float)config->width;
+    chunk_mesh->set_custom_aabb(AABB(Vector3(0.0f, tile.min_height, 0.0f),
+                                     Vector3(width, tile.max_height - tile.min_height, width)));
+    apply_lod(chunk_mesh, lod);
+    tiles.queue(position, std::move(tile));
+    return chunk_mesh;
+}
+
+void HeightmapRenderer::apply_lod(MeshInstance3D* chunk_mesh, const ChunkLod& lod) const {
+    chunk_mesh->set_mesh(get_grid_mesh(lod.level));
+
+    // Spans in texels of the coarser neighbour's edge; 1 leaves the edge as is
+    float spans[ChunkLod::EDGE_MAX];
+    for (int edge = 0; edge < ChunkLod::EDGE_MAX; ++edge) {
+        spans[edge] = lod.edge_levels[edge] > lod.level ? (float)(1 << lod.edge_levels[edge]) : 1.0f;
+    }
+    chunk_mesh->set_instance_shader_parameter("height_tile_edge_spans", Vector4(spans[0], spans[1], spans[2], spans[3]));
+}
+
+void HeightmapRenderer::attach_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos) {
+    refresh_material();
+    chunk_mesh->set_material_override(material.is_valid() ? Ref<Material>(material) : config->terrain_material);
+
+    HeightTile tile;
+    auto placement = tiles.place(chunk_pos, tile);
+    if (!placement.has_value()) {
+        return;
+    }
+    upload_tile(placement->layer, placement->grown, tile);
+    chunk_mesh->set_instance_shader_parameter("height_tile_layer", placement->layer);
+}
+
+void HeightmapRenderer::release_chunk(Vector2i chunk_pos) {
+    tiles.release(chunk_pos);
+}
+
+void HeightmapRenderer::reset_chunk(MeshInstance3D* chunk_mesh) const {
+    chunk_mesh->set_custom_aabb(AABB());
+    chunk_mesh->set_instance_shader_parameter("height_tile_layer", Variant());
+    chunk_mesh->set_instance_shader_parameter("height_tile_edge_spans", Variant());
+
+    // Grid meshes are shared by every heightmap chunk; the mesh path would
+    // rebuild one in place if it took it as its buffer
+    Ref<Mesh> mesh = chunk_mesh->get_mesh();
+    if (mesh.is_null()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(grid_meshes_mutex);
+    for (const auto& [level, grid_mesh] : grid_meshes) {
+        if (grid_mesh.ptr() == mesh.ptr()) {
+            chunk_mesh->set_mesh(Ref<Mesh>());
+            break;
+        }
+    }
+}
+
+void HeightmapRenderer::clear() {
+    tiles.clear();
+}
+
+Ref<ArrayMesh> HeightmapRenderer::get_grid_mesh(int level) const {
+    std::lock_guard<std::mutex> lock(grid_meshes_mutex);
+    auto it = grid_meshes.find(level);
+    if (it != grid_meshes.end()) {
+        return it->second;
+    }
+
+    // Flat grid with the chunk's vertex layout; UVs locate each vertex's texel
+    int segments = config->segment_count >> level;
+    int vertices_per_row = segments + 1;
+    float vertex_spacing = config->width / (float)segments;
+    PackedVector3Array vertices;
+    PackedVector3Array normals;
+    PackedVector2Array uvs;
+    vertices.resize(vertices_per_row * vertices_per_row);
+    normals.resize(vertices_per_row * vertices_per_row);
+    uvs.resize(vertices_per_row * vertices_per_row);
+
+    Vector3* vertex_out = vertices.ptrw();
+    Vector3* normal_out = normals.ptrw();
+    Vector2* uv_out = uvs.ptrw();
+    for (int z = 0; z <= segments; ++z) {
+        for (int x = 0; x <= segments; ++x) {
+            int i = z * vertices_per_row + x;
+            vertex_out[i] = Vector3(x * vertex_spacing, 0.0f, z * vertex_spacing);
+            normal_out[i] = Vector3(0.0f, 1.0f, 0.0f);
+            uv_out[i] = Vector2(x / (float)segments, z / (float)segments);
+        }
+    }
+
+    Array arrays;
+    arrays.resize(Mesh::ARRAY_MAX);
+    arrays[Mesh::ARRAY_VERTEX] = vertices;
+    arrays[Mesh::ARRAY_NORMAL] = normals;
+    arrays[Mesh::ARRAY_TEX_UV] = uvs;
+    arrays[Mesh::ARRAY_INDEX] = ChunkIndexBuffers::get(segments);
+
+    Ref<ArrayMesh> mesh;
+    mesh.instantiate();
+    mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    grid_meshes.emplace(level, mesh);
+    return mesh;
+}
+
+void HeightmapRenderer::refresh_material() {
+    if (material_resolved && source_material == config->terrain_material) {
+        return;
+    }
+    material_resolved = true;
+    source_material = config->terrain_material;
+    material = Ref<ShaderMaterial>();
+
+    Ref<ShaderMaterial> shader_material = source_material;
+    if (shader_material.is_null()) {
+        UtilityFunctions::push_warning("gpu_heightmap needs a ShaderMaterial using the terrain shader; chunks will render flat");
+        return;
+    }
+
+    // A copy, so the tile uniforms are never saved into the user's material
+    material = shader_material->duplicate();
+    material->set_shader_parameter("use_height_tiles", true);
+    material->set_shader_parameter("height_tile_spacing", config->width / (float)config->segment_count);
+    if (tile_texture.is_valid()) {
+        material->set_shader_parameter("height_tiles", tile_texture);
+    }
+}
+
+void HeightmapRenderer::upload_tile(int layer, bool grown, const HeightTile& tile) {
+    Ref<Image> image = create_tile_image(tile);
+
+    if (tile_texture.is_null() || grown || (int)layer_images.size() <= layer) {
+        // (Re)create the array at full capacity; unused layers stay blank
+        int capacity = tiles.get_capacity();
+        Ref<Image> blank = Image::create_empty(tile.size, tile.size, false, Image::FORMAT_RF);
+        layer_images.resize(capacity, blank);
+        layer_images[layer] = image;
+
+        TypedArray<Ref<Image>> images;
+        for (const Ref<Image>& layer_image : layer_images) {
+            images.push_back(layer_image);
+        }
+        if (tile_texture.is_null()) {
+            tile_texture.instantiate();
+        }
+        tile_texture->create_from_images(images);
+        if (material.is_valid()) {
+            material->set_shader_parameter("height_tiles", tile_texture);
+        }
+        return;
+    }
+
+    layer_images[layer] = image;
+    tile_texture->update_layer(image, layer);
+}
+
+Ref<Image> HeightmapRenderer::create_tile_image(const HeightTile& tile) {
+    PackedByteArray data;
+    data.resize(tile.heights.size() * sizeof(float));
+    std::memcpy(data.ptrw(), tile.heights.data(), tile.heights.size() * sizeof(float));
+    return Image::create_from_data(tile.size, tile.size, false, Image::FORMAT_RF, data);
+}
@@ -0,0 +1,72 @@
+//==========================================
+// heightmap_renderer.h - GPU-displaced chunk rendering
+//==========================================
+#ifndef HEIGHTMAP_RENDERER_H
+#define HEIGHTMAP_RENDERER_H
+
+#include "terrain_config.h"
+#include "height_sampler.h"
+#include "height_tiles.h"
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/classes/texture2d_array.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+// Alternative to MeshGenerator when gpu_heightmap is enabled. Every chunk
+// draws the same flat grid mesh (one per LOD level), and the terrain shader
+// displaces it from the chunk's layer in a shared height texture array. The
+// CPU only produces the height tile, so there are no per-chunk vertex arrays.
+class HeightmapRenderer {
+private:
+    const TerrainConfig* config;
+    const HeightSampler* height_sampler;
+    HeightTileSet tiles;
+
+    // Main thread only
+    Ref<Texture2DArray> tile_texture;
+    std::vector<Ref<Image>> layer_images;  // Kept to rebuild the array when it grows
+    Ref<Material> source_material;
+    Ref<ShaderMaterial> material;          // Copy of terrain_material with the tile uniforms bound
+    bool material_resolved = false;
+
+    mutable std::mutex grid_meshes_mutex;
+    mutable std::unordered_map<int, Ref<ArrayMesh>> grid_meshes;  // By LOD level
+
+public:
+    HeightmapRenderer(const TerrainConfig* terrain_config, const HeightSampler* sampler);
+
+    // Loader thread. Produces the chunk's height tile and queues it for
+    // upload; chunks hidden under the sea (when skipping is enabled) get no
+    // mesh and no tile. A recycled instance is set up again instead of a new one.
+    MeshInstance3D* generate_chunk(Vector2i position, const RiverDistanceField& river_field, const ChunkLod& lod,
+                                   MeshInstance3D* recycled = nullptr);
+
+    // Swaps the grid for lod.level and updates the edge stitching
+    void apply_lod(MeshInstance3D* chunk_mesh, const ChunkLod& lod) const;
+
+    // Main thread. Uploads the chunk's queued tile and binds its layer and material.
+    void attach_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos);
+    void release_chunk(Vector2i chunk_pos);
+    // Undoes what generate_chunk and attach_chunk set on an instance, so a
+    // pooled one can be reused by either path. Any thread; the instance must be out of the tree.
+    void reset_chunk(MeshInstance3D* chunk_mesh) const;
+    void clear();
+
+    const HeightTileSet& get_tiles() const { return tiles; }
+
+private:
+    Ref<ArrayMesh> get_grid_mesh(int level) const;
+    void refresh_material();
+    void upload_tile(int layer, bool grown, const HeightTile& tile);
+    static Ref<Image> create_tile_image(const HeightTile& tile);
+};
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+//==========================================
+// job_pool.cpp
+//==========================================
+#include "job_pool.h"
+#include <algorithm>
+
+using namespace godot;
+
+namespace {
+
+// Pool and worker index of the calling thread, so jobs queued by a job stay local
+thread_local const JobPool* current_pool = nullptr;
+thread_local int current_worker = -1;
+
+}
+
+JobPool::JobPool(int thread_count) {
+    int count = std::max(thread_count, 1);
+    for (int i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < count; ++i) {
+        threads.emplace_back([this, i]() { worker_loop(i); });
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    threads.clear();  // Joins
+}
+
+int JobPool::default_thread_count() {
+    int cores = (int)std::thread::hardware_concurrency();
+    return std::max(cores - 1, 1);
+}
+
+void JobPool::submit(Job job, int priority) {
+    {
+        // Counted before it is queued, so pending never drops below the real
+        // count, and under wake_mutex so a worker about to sleep cannot miss it
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        pending.fetch_add(1);
+    }
+    int index = (current_pool == this) ? current_worker : (int)(next_worker.fetch_add(1) % workers.size());
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->jobs.push({priority, next_sequence.fetch_add(1), std::move(job)});
+    }
+    wake.notify_one();
+}
+
+void JobPool::cancel_pending() {
+    size_t dropped = 0;
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        dropped += worker->jobs.size();
+        worker->jobs = {};
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        pending.fetch_sub(dropped);
+    }
+    idle.notify_all();
+}
+
+void JobPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    idle.wait(lock, [this]() { return pending.load() == 0 && active.load() == 0; });
+}
+
+void JobPool::worker_loop(int index) {
+    current_pool = this;
+    current_worker = index;
+
+    Job job;
+    while (true) {
+        if (take_job(index, job)) {
+            job();
+            job = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                active.fetch_sub(1);
+            }
+            idle.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.wait(lock, [this]() { return stopping || pending.load() > 0; });
+        if (stopping) {
+            return;
+        }
+        // pending can briefly count a job that is still being queued or that
+        // another worker is taking; take_job then comes back empty and the
+        // worker waits again
+    }
+}
+
+bool JobPool::take_job(int index, Job& r_job) {
+    if (pop_from(*workers[index], r_job)) {
+        return true;
+    }
+
+    // Steal the most urgent job of the other workers, starting at the next one
+    int count = (int)workers.size();
+    for (int offset = 1; offset < count; ++offset) {
+        if (pop_from(*workers[(index + offset) % count], r_job)) {
+            steals.fetch_add(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobPool::pop_from(Worker& worker, Job& r_job) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.jobs.empty()) {
+        return false;
+    }
+    // std::priority_queue only exposes a const top; the entry is popped right after
+    r_job = std::move(const_cast<Entry&>(worker.jobs.top()).job);
+    worker.jobs.pop();
+
+    // Counted as active before it stops being pending, so wait_idle never sees neither
+    active.fetch_add(1);
+    pending.fetch_sub(1);
+    return true;
+}
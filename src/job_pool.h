@@ -0,0 +1,86 @@
+//==========================================
+// job_pool.h - Work-stealing pool for chunk generation jobs
+//==========================================
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+// Fixed set of worker threads, each with its own priority queue. Jobs
+// submitted from outside the pool are spread round-robin; jobs submitted by a
+// running job (the next stage of the same chunk) stay on that worker. A worker
+// runs its own most urgent job first and, when it has none, steals the most
+// urgent job of another worker, so all cores stay busy without one shared
+// queue for every thread to contend on.
+class JobPool {
+public:
+    using Job = std::function<void()>;
+
+    explicit JobPool(int thread_count);
+    ~JobPool();  // Drops pending jobs and joins the workers
+
+    // Lower priorities run first; equal priorities run in submission order
+    void submit(Job job, int priority);
+
+    // Drops jobs that have not started; running ones finish normally
+    void cancel_pending();
+
+    // Blocks until no job is queued or running
+    void wait_idle();
+
+    int get_thread_count() const { return (int)workers.size(); }
+    size_t get_pending_count() const { return pending.load(); }
+    int get_active_count() const { return active.load(); }
+    uint64_t get_steal_count() const { return steals.load(); }
+
+    // One worker per core, leaving one for the main thread
+    static int default_thread_count();
+
+private:
+    struct Entry {
+        int priority;
+        uint64_t sequence;
+        Job job;
+    };
+    struct EntryOrder {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.priority != b.priority ? a.priority > b.priority : a.sequence > b.sequence;
+        }
+    };
+    struct Worker {
+        std::mutex mutex;
+        std::priority_queue<Entry, std::vector<Entry>, EntryOrder> jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::jthread> threads;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;  // Jobs were queued, or the pool is stopping
+    std::condition_variable idle;  // A job finished or was dropped
+    bool stopping = false;
+
+    std::atomic<size_t> pending{0};
+    std::atomic<int> active{0};
+    std::atomic<uint64_t> next_sequence{0};
+    std::atomic<uint32_t> next_worker{0};
+    std::atomic<uint64_t> steals{0};
+
+    void worker_loop(int index);
+    bool take_job(int index, Job& r_job);
+    bool pop_from(Worker& worker, Job& r_job);
+};
+
+}
+
+#endif
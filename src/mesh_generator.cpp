@@ -2,9 +2,14 @@
 // mesh_generator.cpp
 //==========================================
 #include "mesh_generator.h"
-#include "river_generator.h"
-#include <godot_cpp/classes/surface_tool.hpp>
-#include <godot_cpp/classes/array_mesh.hpp>
+#include "chunk_index_buffers.h"
+#include "heightfield_simplifier.h"
+#include "vertex_cache_optimizer.h"
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 using namespace godot;
 
@@ -12,123 +17,345 @@ MeshGenerator::MeshGenerator(const TerrainConfig* terrain_config, const HeightSa
     : config(terrain_config), height_sampler(sampler) {
 }
 
-MeshInstance3D* MeshGenerator::generate_chunk_mesh(Vector2i position) {
-    auto st = memnew(SurfaceTool);
-    st->begin(Mesh::PRIMITIVE_TRIANGLES);
+MeshInstance3D* MeshGenerator::generate_chunk_mesh(Vector2i position, const ChunkLod& lod, MeshInstance3D* recycled) {
+    return generate_chunk_mesh_with_rivers(position, RiverDistanceField(), lod, recycled);
+}
+
+MeshInstance3D* MeshGenerator::generate_chunk_mesh_with_rivers(Vector2i position, const RiverDistanceField& river_field,
+                                                               const ChunkLod& lod, MeshInstance3D* recycled) {
+    if (!recycled) {
+        return setup_chunk_instance(memnew(MeshInstance3D), position, generate_chunk_surface(position, river_field, lod));
+    }
+    Ref<ArrayMesh> old_mesh = recycled->get_mesh();
+    return setup_chunk_instance(recycled, position, generate_chunk_surface(position, river_field, lod, old_mesh));
+}
 
+MeshInstance3D* MeshGenerator::generate_chunk_container(Vector2i position, MeshInstance3D* recycled) {
+    return setup_chunk_instance(recycled ? recycled : memnew(MeshInstance3D), position, Ref<ArrayMesh>());
+}
+
+Ref<ArrayMesh> MeshGenerator::generate_chunk_surface(Vector2i position, const RiverDistanceField& river_field, const ChunkLod& lod,
+                                                     const Ref<ArrayMesh>& recycled) const {
     float step = config->width / (float)config->segment_count;
     int extended_size = config->segment_count + 3;
 
+    // Heights (and carving) always come from the full-resolution lattice; coarser
+    // levels pick every 2^level-th sample, so shared vertices agree across levels
     PackedFloat32Array height_data;
     height_data.resize(extended_size * extended_size);
-    height_sampler->precompute_height_data(position, step, extended_size, height_data);
-
-    generate_vertices(extended_size, height_data, step, st);
-    generate_indices(st);
+    if (river_field.is_empty()) {
+        height_sampler->precompute_height_data(position, extended_size, height_data);
+    } else {
+        // Use river-aware height sampling
+        height_sampler->precompute_height_data_with_rivers(position, extended_size, height_data, river_field);
+    }
 
-    auto mesh = st->commit();
-    memdelete(st);
+    // Classify from the height range of the extended grid, so the ring used
+    // for normals is flat (or submerged) too
+    const float* heights = height_data.ptr();
+    auto range = std::minmax_element(heights, heights + extended_size * extended_size);
+    float min_height = *range.first;
+    float max_height = *range.second;
+    if (config->skip_underwater_chunks && max_height < config->sea_level) {
+        return Ref<ArrayMesh>();
+    }
+    if (max_height - min_height <= FLAT_HEIGHT_EPSILON) {
+        return get_flat_mesh(min_height);
+    }
 
-    MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
-    mesh_instance->set_mesh(mesh);
+    // Fill the surface arrays directly and hand them to the mesh in one call
+    PackedVector3Array vertices;
+    PackedVector3Array normals;
+    PackedVector2Array uvs;
+    generate_vertices(extended_size, height_data, step, lod, vertices, normals, uvs);
+    stitch_edges(lod, vertices);
+
+    // Far chunks cover fewer pixels per world unit, so they tolerate more error
+    int segments = config->segment_count >> lod.level;
+    float tolerance = config->mesh_simplification_tolerance * (1 << lod.level);
+    PackedInt32Array indices;
+    if (tolerance <= 0.0f || !simplify_surface(segments, tolerance, vertices, normals, uvs, indices)) {
+        // Full grids of one resolution differ only in positions and normals
+        if (refresh_surface(recycled, segments, vertices, normals, min_height, max_height)) {
+            return recycled;
+        }
+        indices = ChunkIndexBuffers::get(segments);
+    }
 
-    float chunk_world_x = position.x * config->width;
-    float chunk_world_z = position.y * config->width;
-    mesh_instance->set_position(Vector3(chunk_world_x, 0, chunk_world_z));
+    Array arrays;
+    arrays.resize(Mesh::ARRAY_MAX);
+    arrays[Mesh::ARRAY_VERTEX] = vertices;
+    arrays[Mesh::ARRAY_NORMAL] = normals;
+    arrays[Mesh::ARRAY_TEX_UV] = uvs;
+    arrays[Mesh::ARRAY_INDEX] = indices;
+
+    Ref<ArrayMesh> mesh;
+    mesh.instantiate();
+    mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    return mesh;
+}
 
-    if (!config->terrain_material.is_null()) {
-        mesh_instance->set_material_override(config->terrain_material);
+Ref<ArrayMesh> MeshGenerator::get_flat_mesh(float height) const {
+    std::lock_guard<std::mutex> lock(flat_meshes_mutex);
+    auto it = flat_meshes.find(height);
+    if (it != flat_meshes.end()) {
+        return it->second;
     }
 
-    return mesh_instance;
+    // One quad covers the chunk. Neighbours' edges along it are straight
+    // lines at the same height, so no stitching is needed at any LOD.
+    float width = (float)config->width;
+    PackedVector3Array vertices;
+    PackedVector3Array normals;
+    PackedVector2Array uvs;
+    PackedInt32Array indices;
+    vertices.resize(4);
+    normals.resize(4);
+    uvs.resize(4);
+    indices.resize(6);
+
+    Vector3* vertex_out = vertices.ptrw();
+    Vector3* normal_out = normals.ptrw();
+    Vector2* uv_out = uvs.ptrw();
+    for (int corner = 0; corner < 4; ++corner) {
+        int x = corner & 1;
+        int z = corner >> 1;
+        vertex_out[corner] = Vector3(x * width, height, z * width);
+        normal_out[corner] = Vector3(0.0f, 1.0f, 0.0f);
+        uv_out[corner] = Vector2((float)x, (float)z);
+    }
+    const int32_t quad[6] = {0, 1, 2, 1, 3, 2}; // Same winding as the grid
+    std::copy(quad, quad + 6, indices.ptrw());
+
+    Array arrays;
+    arrays.resize(Mesh::ARRAY_MAX);
+    arrays[Mesh::ARRAY_VERTEX] = vertices;
+    arrays[Mesh::ARRAY_NORMAL] = normals;
+    arrays[Mesh::ARRAY_TEX_UV] = uvs;
+    arrays[Mesh::ARRAY_INDEX] = indices;
+
+    Ref<ArrayMesh> mesh;
+    mesh.instantiate();
+    mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+
+    // Bounded in case a graph produces many distinct plateau heights
+    if (flat_meshes.size() < MAX_FLAT_MESHES) {
+        flat_meshes.emplace(height, mesh);
+    }
+    return mesh;
 }
 
-MeshInstance3D* MeshGenerator::generate_chunk_mesh_with_rivers(Vector2i position, const std::vector<RiverSegment>& river_segments) {
-    auto st = memnew(SurfaceTool);
-    st->begin(Mesh::PRIMITIVE_TRIANGLES);
+bool MeshGenerator::is_flat_mesh(const Ref<ArrayMesh>& mesh) const {
+    std::lock_guard<std::mutex> lock(flat_meshes_mutex);
+    for (const auto& entry : flat_meshes) {
+        if (entry.second == mesh) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    float step = config->width / (float)config->segment_count;
-    int extended_size = config->segment_count + 3;
+bool MeshGenerator::refresh_surface(const Ref<ArrayMesh>& mesh, int segments, const PackedVector3Array& vertices,
+                                    const PackedVector3Array& normals, float min_height, float max_height) const {
+    int vertex_count = (int)vertices.size();
+    if (mesh.is_null() || mesh->get_surface_count() != 1 ||
+        mesh->surface_get_array_len(0) != vertex_count ||
+        mesh->surface_get_array_index_len(0) != segments * segments * 6 ||
+        is_flat_mesh(mesh)) {
+        return false;
+    }
 
-    PackedFloat32Array height_data;
-    height_data.resize(extended_size * extended_size);
-    
-    // Use river-aware height sampling
-    height_sampler->precompute_height_data_with_rivers(position, step, extended_size, height_data, river_segments);
+    // Only positions and octahedral normals live in the vertex stream of the
+    // surfaces built here; anything else needs a full rebuild
+    uint64_t format = (int64_t)mesh->surface_get_format(0);
+    if (!(format & Mesh::ARRAY_FORMAT_NORMAL) ||
+        (format & (Mesh::ARRAY_FORMAT_TANGENT | Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES))) {
+        return false;
+    }
+    RenderingServer* rendering_server = RenderingServer::get_singleton();
+    BitField<RenderingServer::ArrayFormat> stream_format = (int64_t)format;
+    uint32_t stride = rendering_server->mesh_surface_get_format_vertex_stride(stream_format, vertex_count);
+    uint32_t position_offset = rendering_server->mesh_surface_get_format_offset(stream_format, vertex_count, RenderingServer::ARRAY_VERTEX);
+    uint32_t normal_offset = rendering_server->mesh_surface_get_format_offset(stream_format, vertex_count, RenderingServer::ARRAY_NORMAL);
+
+    PackedByteArray vertex_stream;
+    vertex_stream.resize((int64_t)stride * vertex_count);
+    uint8_t* out = vertex_stream.ptrw();
+    const Vector3* vertex_data = vertices.ptr();
+    const Vector3* normal_data = normals.ptr();
+    for (int i = 0; i < vertex_count; ++i) {
+        uint8_t* element = out + (size_t)i * stride;
+        const float position[3] = {(float)vertex_data[i].x, (float)vertex_data[i].y, (float)vertex_data[i].z};
+        std::memcpy(element + position_offset, position, sizeof(position));
+
+        // Same 16-bit octahedral encoding the engine uses when building the surface
+        Vector2 encoded = normal_data[i].octahedron_encode();
+        const uint16_t normal[2] = {
+            (uint16_t)std::clamp(encoded.x * 65535.0f, 0.0f, 65535.0f),
+            (uint16_t)std::clamp(encoded.y * 65535.0f, 0.0f, 65535.0f)
+        };
+        std::memcpy(element + normal_offset, normal, sizeof(normal));
+    }
+    mesh->surface_update_vertex_region(0, 0, vertex_stream);
 
-    generate_vertices(extended_size, height_data, step, st);
-    generate_indices(st);
+    // The surface keeps the bounds it was created with; culling needs the new ones
+    float width = (float)config->width;
+    mesh->set_custom_aabb(AABB(Vector3(0.0f, min_height, 0.0f), Vector3(width, max_height - min_height, width)));
+    return true;
+}
 
-    auto mesh = st->commit();
-    memdelete(st);
+int MeshGenerator::max_lod_level(int segment_count, int lod_levels) {
+    int level = 0;
+    while (level + 1 < lod_levels && segment_count % (2 << level) == 0) {
+        ++level;
+    }
+    return level;
+}
 
-    MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
+MeshInstance3D* MeshGenerator::setup_chunk_instance(MeshInstance3D* mesh_instance, Vector2i position, const Ref<ArrayMesh>& mesh) const {
     mesh_instance->set_mesh(mesh);
 
     float chunk_world_x = position.x * config->width;
     float chunk_world_z = position.y * config->width;
     mesh_instance->set_position(Vector3(chunk_world_x, 0, chunk_world_z));
 
-    if (!config->terrain_material.is_null()) {
-        mesh_instance->set_material_override(config->terrain_material);
-    }
+    // Set unconditionally so a recycled instance drops a material removed since
+    mesh_instance->set_material_override(config->terrain_material);
 
     return mesh_instance;
 }
 
-void MeshGenerator::generate_vertices(int extended_size, const PackedFloat32Array& height_data, float step, SurfaceTool* st) const {
-    float inv_segment_count = 1.0f / (float)config->segment_count;
-    float width_inv_segment = config->width * inv_segment_count;
+void MeshGenerator::generate_vertices(int extended_size, const PackedFloat32Array& height_data, float step, const ChunkLod& lod,
+                                      PackedVector3Array& vertices, PackedVector3Array& normals, PackedVector2Array& uvs) const {
+    int stride = 1 << lod.level;
+    int segments = config->segment_count >> lod.level;
+    int vertices_per_row = segments + 1;
+    int vertex_count = vertices_per_row * vertices_per_row;
+    vertices.resize(vertex_count);
+    normals.resize(vertex_count);
+    uvs.resize(vertex_count);
+
+    Vector3* vertex_out = vertices.ptrw();
+    Vector3* normal_out = normals.ptrw();
+    Vector2* uv_out = uvs.ptrw();
+    const float* heights = height_data.ptr();
+
+    float inv_segments = 1.0f / (float)segments;
+    float vertex_spacing = step * stride;
     float double_step = 2.0f * step;
 
-    for (int z = 0; z <= config->segment_count; ++z) {
-        float local_z = z * width_inv_segment;
-        float uv_z = z * inv_segment_count;
-        int base_idx = (z + 1) * extended_size;
-
-        for (int x = 0; x <= config->segment_count; ++x) {
-            float local_x = x * width_inv_segment;
-            float uv_x = x * inv_segment_count;
-
-            float height = height_data[base_idx + (x + 1)];
-
-            float height_left = height_data[base_idx + x];
-            float height_right = height_data[base_idx + (x + 2)];
-            float height_up = height_data[base_idx - extended_size + (x + 1)];
-            float height_down = height_data[base_idx + extended_size + (x + 1)];
-
-            Vector3 tangent_x = Vector3(double_step, height_right - height_left, 0.0f);
-            Vector3 tangent_z = Vector3(0.0f, height_down - height_up, double_step);
-            Vector3 normal = tangent_z.cross(tangent_x).normalized();
-
-            st->set_uv(Vector2(uv_x, uv_z));
-            st->set_normal(normal);
-            st->set_color(Color(1.0f, 1.0f, 1.0f, 1.0f));
-            st->add_vertex(Vector3(local_x, height, local_z));
+    for (int z = 0; z <= segments; ++z) {
+        float local_z = z * vertex_spacing;
+        float uv_z = z * inv_segments;
+
+        // Rows of the extended grid around this vertex row; column x * stride + 1 is the vertex
+        const float* row = heights + (z * stride + 1) * extended_size;
+        const float* row_up = row - extended_size;
+        const float* row_down = row + extended_size;
+
+        Vector3* row_vertices = vertex_out + z * vertices_per_row;
+        Vector3* row_normals = normal_out + z * vertices_per_row;
+        Vector2* row_uvs = uv_out + z * vertices_per_row;
+
+        // Central-difference normal on the full-resolution lattice, so every
+        // level shades like level 0: cross((0, dz, 2s), (2s, dx, 0)) is parallel
+        // to (-dx, 2s, -dz). Branch-free and independent per column, so the
+        // compiler can vectorize the row.
+        for (int x = 0; x <= segments; ++x) {
+            int column = x * stride;
+            float dx = row[column + 2] - row[column];
+            float dz = row_down[column + 1] - row_up[column + 1];
+            float inv_length = 1.0f / std::sqrt(dx * dx + double_step * double_step + dz * dz);
+
+            row_normals[x] = Vector3(-dx * inv_length, double_step * inv_length, -dz * inv_length);
+            row_vertices[x] = Vector3(x * vertex_spacing, row[column + 1], local_z);
+            row_uvs[x] = Vector2(x * inv_segments, uv_z);
         }
     }
 }
 
-void MeshGenerator::generate_indices(SurfaceTool* st) const {
-    int vertices_per_row = config->segment_count + 1;
+void MeshGenerator::stitch_edges(const ChunkLod& lod, PackedVector3Array& vertices) const {
+    int segments = config->segment_count >> lod.level;
+    int vertices_per_row = segments + 1;
+    Vector3* vertex_data = vertices.ptrw();
 
-    for (int z = 0; z < config->segment_count; ++z) {
-        int current_row = z * vertices_per_row;
-        int next_row = current_row + vertices_per_row;
+    // Where the neighbour is coarser, move the in-between edge vertices onto
+    // the neighbour's straight edge so the two meshes share the same line
+    auto stitch = [&](int first, int element_stride, int edge_level) {
+        if (edge_level <= lod.level) {
+            return;
+        }
+        int span = 1 << (edge_level - lod.level);
+        float inv_span = 1.0f / span;
+        for (int i = 0; i < vertices_per_row; ++i) {
+            int offset = i % span;
+            if (offset == 0) {
+                continue;
+            }
+            float start = vertex_data[first + (i - offset) * element_stride].y;
+            float end = vertex_data[first + (i - offset + span) * element_stride].y;
+            vertex_data[first + i * element_stride].y = start + (end - start) * (offset * inv_span);
+        }
+    };
+
+    stitch(0, vertices_per_row, lod.edge_levels[ChunkLod::EDGE_NEG_X]);
+    stitch(segments, vertices_per_row, lod.edge_levels[ChunkLod::EDGE_POS_X]);
+    stitch(0, 1, lod.edge_levels[ChunkLod::EDGE_NEG_Z]);
+    stitch(segments * vertices_per_row, 1, lod.edge_levels[ChunkLod::EDGE_POS_Z]);
+}
+
+bool MeshGenerator::simplify_surface(int segments, float tolerance, PackedVector3Array& vertices, PackedVector3Array& normals,
+                                     PackedVector2Array& uvs, PackedInt32Array& indices) const {
+    int vertex_count = (int)vertices.size();
+    const Vector3* vertex_data = vertices.ptr();
+    const Vector3* normal_data = normals.ptr();
+    const Vector2* uv_data = uvs.ptr();
+    std::vector<float> heights(vertex_count);
+    for (int i = 0; i < vertex_count; ++i) {
+        heights[i] = vertex_data[i].y;
+    }
 
-        for (int x = 0; x < config->segment_count; ++x) {
-            int i0 = current_row + x;
-            int i1 = i0 + 1;
-            int i2 = next_row + x;
-            int i3 = i2 + 1;
+    std::vector<int32_t> triangles;
+    if (!simplify_height_grid(heights.data(), segments, tolerance, triangles)) {
+        return false;
+    }
+    if ((int)triangles.size() == segments * segments * 6) {
+        return false; // Nothing merged; keep the shared full-grid buffer
+    }
 
-            st->add_index(i0);
-            st->add_index(i1);
-            st->add_index(i2);
+    // Keep only the vertices the simplified triangles use
+    std::vector<int32_t> remap(vertex_count, -1);
+    int kept = 0;
+    for (int32_t& index : triangles) {
+        if (remap[index] < 0) {
+            remap[index] = kept++;
+        }
+        index = remap[index];
+    }
 
-            st->add_index(i1);
-            st->add_index(i3);
-            st->add_index(i2);
+    PackedVector3Array kept_vertices;
+    PackedVector3Array kept_normals;
+    PackedVector2Array kept_uvs;
+    kept_vertices.resize(kept);
+    kept_normals.resize(kept);
+    kept_uvs.resize(kept);
+    Vector3* vertex_out = kept_vertices.ptrw();
+    Vector3* normal_out = kept_normals.ptrw();
+    Vector2* uv_out = kept_uvs.ptrw();
+    for (int i = 0; i < vertex_count; ++i) {
+        if (remap[i] >= 0) {
+            vertex_out[remap[i]] = vertex_data[i];
+            normal_out[remap[i]] = normal_data[i];
+            uv_out[remap[i]] = uv_data[i];
         }
     }
+
+    optimize_vertex_cache(triangles, kept);
+
+    indices.resize((int64_t)triangles.size());
+    std::copy(triangles.begin(), triangles.end(), indices.ptrw());
+    vertices = kept_vertices;
+    normals = kept_normals;
+    uvs = kept_uvs;
+    return true;
 }
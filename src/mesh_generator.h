@@ -7,30 +7,63 @@
 #include "terrain_config.h"
 #include "height_sampler.h"
 #include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace godot {
 
-// Forward declaration
-struct RiverSegment;
-
 class MeshGenerator {
 private:
     const TerrainConfig* config;
     const HeightSampler* height_sampler;
 
+    // Chunks whose heights are all the same share one quad per height
+    static constexpr float FLAT_HEIGHT_EPSILON = 0.001f;
+    static constexpr size_t MAX_FLAT_MESHES = 64;
+    mutable std::mutex flat_meshes_mutex;
+    mutable std::unordered_map<float, Ref<ArrayMesh>> flat_meshes;
+
 public:
     MeshGenerator(const TerrainConfig* terrain_config, const HeightSampler* sampler);
 
-    MeshInstance3D* generate_chunk_mesh(Vector2i position);
-    MeshInstance3D* generate_chunk_mesh_with_rivers(Vector2i position, const std::vector<RiverSegment>& river_segments);
+    // A recycled instance (empty, out of the scene) is set up again instead of
+    // creating a new one, and its mesh is rewritten in place when possible
+    MeshInstance3D* generate_chunk_mesh(Vector2i position, const ChunkLod& lod = ChunkLod(),
+                                        MeshInstance3D* recycled = nullptr);
+    MeshInstance3D* generate_chunk_mesh_with_rivers(Vector2i position, const RiverDistanceField& river_field,
+                                                    const ChunkLod& lod = ChunkLod(), MeshInstance3D* recycled = nullptr);
+
+    // Chunk instance without a terrain surface, for foliage and rivers when
+    // the terrain is drawn some other way
+    MeshInstance3D* generate_chunk_container(Vector2i position, MeshInstance3D* recycled = nullptr);
+
+    // Terrain surface alone, used to swap the LOD of a chunk already in the
+    // scene. An empty river_field skips carving. Flat chunks get a shared
+    // quad; chunks hidden under the sea (when skipping is enabled) get null.
+    // A full-grid surface with the same vertex count as recycled (a mesh no
+    // longer displayed) is uploaded into its vertex buffer, and recycled is
+    // returned.
+    Ref<ArrayMesh> generate_chunk_surface(Vector2i position, const RiverDistanceField& river_field, const ChunkLod& lod,
+                                          const Ref<ArrayMesh>& recycled = Ref<ArrayMesh>()) const;
+
+    // Highest usable LOD level: below lod_levels and keeping segment_count divisible by 2^level
+    static int max_lod_level(int segment_count, int lod_levels);
 
 private:
-    void generate_vertices(int extended_size, const PackedFloat32Array& height_data,
-                          float step, class SurfaceTool* st) const;
-    void generate_indices(class SurfaceTool* st) const;
+    Ref<ArrayMesh> get_flat_mesh(float height) const;
+    bool is_flat_mesh(const Ref<ArrayMesh>& mesh) const;
+    MeshInstance3D* setup_chunk_instance(MeshInstance3D* mesh_instance, Vector2i position, const Ref<ArrayMesh>& mesh) const;
+    bool refresh_surface(const Ref<ArrayMesh>& mesh, int segments, const PackedVector3Array& vertices,
+                         const PackedVector3Array& normals, float min_height, float max_height) const;
+    void generate_vertices(int extended_size, const PackedFloat32Array& height_data, float step, const ChunkLod& lod,
+                          PackedVector3Array& vertices, PackedVector3Array& normals, PackedVector2Array& uvs) const;
+    void stitch_edges(const ChunkLod& lod, PackedVector3Array& vertices) const;
+    bool simplify_surface(int segments, float tolerance, PackedVector3Array& vertices, PackedVector3Array& normals,
+                          PackedVector2Array& uvs, PackedInt32Array& indices) const;
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
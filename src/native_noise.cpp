@@ -0,0 +1,706 @@
+//==========================================
+// native_noise.cpp
+//==========================================
+#include "native_noise.h"
+#include "utils.h"
+#include <godot_cpp/classes/fast_noise_lite.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+// The kernels below follow FastNoiseLite (MIT, Jordan Peck) so that results
+// match Godot's FastNoiseLite resource. Integer math is done in uint32_t to
+// reproduce the library's wrapping int arithmetic without signed overflow.
+namespace {
+
+constexpr uint32_t PRIME_X = 501125321u;
+constexpr uint32_t PRIME_Y = 1136930381u;
+
+const float GRADIENTS_2D[256] = {
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+    -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+};
+
+inline int32_t fast_floor(float f) {
+    return f >= 0 ? (int32_t)f : (int32_t)f - 1;
+}
+
+inline float lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+inline float interp_hermite(float t) {
+    return t * t * (3 - 2 * t);
+}
+
+inline float interp_quintic(float t) {
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+inline float cubic_lerp(float a, float b, float c, float d, float t) {
+    float p = (d - c) - (a - b);
+    return t * t * t * p + t * t * ((a - b) - p) + t * (c - a) + b;
+}
+
+inline float ping_pong(float t) {
+    t -= (int32_t)(t * 0.5f) * 2;
+    return t < 1 ? t : 2 - t;
+}
+
+inline uint32_t hash_coord(int32_t seed, uint32_t x_primed, uint32_t y_primed) {
+    uint32_t hash = (uint32_t)seed ^ x_primed ^ y_primed;
+    return hash * 0x27d4eb2du;
+}
+
+inline float val_coord(int32_t seed, uint32_t x_primed, uint32_t y_primed) {
+    uint32_t hash = hash_coord(seed, x_primed, y_primed);
+    hash *= hash;
+    hash ^= hash << 19;
+    return (float)(int32_t)hash * (1 / 2147483648.0f);
+}
+
+inline float grad_coord(int32_t seed, uint32_t x_primed, uint32_t y_primed, float xd, float yd) {
+    uint32_t hash = hash_coord(seed, x_primed, y_primed);
+    hash ^= hash >> 15;
+    hash &= 127 << 1;
+    return xd * GRADIENTS_2D[hash] + yd * GRADIENTS_2D[hash | 1];
+}
+
+inline float single_simplex(int32_t seed, float x, float y) {
+    const float SQRT3 = 1.7320508075688772935274463415059f;
+    const float G2 = (3 - SQRT3) / 6;
+
+    int32_t i = fast_floor(x);
+    int32_t j = fast_floor(y);
+    float xi = x - i;
+    float yi = y - j;
+
+    float t = (xi + yi) * G2;
+    float x0 = xi - t;
+    float y0 = yi - t;
+
+    uint32_t ip = (uint32_t)i * PRIME_X;
+    uint32_t jp = (uint32_t)j * PRIME_Y;
+
+    float n0, n1, n2;
+
+    float a = 0.5f - x0 * x0 - y0 * y0;
+    if (a <= 0) {
+        n0 = 0;
+    } else {
+        n0 = (a * a) * (a * a) * grad_coord(seed, ip, jp, x0, y0);
+    }
+
+    float c = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2)) * t + ((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2)) + a);
+    if (c <= 0) {
+        n2 = 0;
+    } else {
+        float x2 = x0 + (2 * G2 - 1);
+        float y2 = y0 + (2 * G2 - 1);
+        n2 = (c * c) * (c * c) * grad_coord(seed, ip + PRIME_X, jp + PRIME_Y, x2, y2);
+    }
+
+    if (y0 > x0) {
+        float x1 = x0 + G2;
+        float y1 = y0 + (G2 - 1);
+        float b = 0.5f - x1 * x1 - y1 * y1;
+        n1 = b <= 0 ? 0 : (b * b) * (b * b) * grad_coord(seed, ip, jp + PRIME_Y, x1, y1);
+    } else {
+        float x1 = x0 + (G2 - 1);
+        float y1 = y0 + G2;
+        float b = 0.5f - x1 * x1 - y1 * y1;
+        n1 = b <= 0 ? 0 : (b * b) * (b * b) * grad_coord(seed, ip + PRIME_X, jp, x1, y1);
+    }
+
+    return (n0 + n1 + n2) * 99.83685446303647f;
+}
+
+inline float single_perlin(int32_t seed, float x, float y) {
+    int32_t x0 = fast_floor(x);
+    int32_t y0 = fast_floor(y);
+
+    float xd0 = x - x0;
+    float yd0 = y - y0;
+    float xd1 = xd0 - 1;
+    float yd1 = yd0 - 1;
+
+    float xs = interp_quintic(xd0);
+    float ys = interp_quintic(yd0);
+
+    uint32_t x0p = (uint32_t)x0 * PRIME_X;
+    uint32_t y0p = (uint32_t)y0 * PRIME_Y;
+    uint32_t x1p = x0p + PRIME_X;
+    uint32_t y1p = y0p + PRIME_Y;
+
+    float xf0 = lerp(grad_coord(seed, x0p, y0p, xd0, yd0), grad_coord(seed, x1p, y0p, xd1, yd0), xs);
+    float xf1 = lerp(grad_coord(seed, x0p, y1p, xd0, yd1), grad_coord(seed, x1p, y1p, xd1, yd1), xs);
+
+    return lerp(xf0, xf1, ys) * 1.4247691104677813f;
+}
+
+inline float single_value(int32_t seed, float x, float y) {
+    int32_t x0 = fast_floor(x);
+    int32_t y0 = fast_floor(y);
+
+    float xs = interp_hermite(x - x0);
+    float ys = interp_hermite(y - y0);
+
+    uint32_t x0p = (uint32_t)x0 * PRIME_X;
+    uint32_t y0p = (uint32_t)y0 * PRIME_Y;
+    uint32_t x1p = x0p + PRIME_X;
+    uint32_t y1p = y0p + PRIME_Y;
+
+    float xf0 = lerp(val_coord(seed, x0p, y0p), val_coord(seed, x1p, y0p), xs);
+    float xf1 = lerp(val_coord(seed, x0p, y1p), val_coord(seed, x1p, y1p), xs);
+
+    return lerp(xf0, xf1, ys);
+}
+
+inline float single_value_cubic(int32_t seed, float x, float y) {
+    int32_t x1 = fast_floor(x);
+    int32_t y1 = fast_floor(y);
+
+    float xs = x - x1;
+    float ys = y - y1;
+
+    uint32_t x1p = (uint32_t)x1 * PRIME_X;
+    uint32_t y1p = (uint32_t)y1 * PRIME_Y;
+    uint32_t x0p = x1p - PRIME_X;
+    uint32_t y0p = y1p - PRIME_Y;
+    uint32_t x2p = x1p + PRIME_X;
+    uint32_t y2p = y1p + PRIME_Y;
+    uint32_t x3p = x1p + (PRIME_X << 1);
+    uint32_t y3p = y1p + (PRIME_Y << 1);
+
+    return cubic_lerp(
+        cubic_lerp(val_coord(seed, x0p, y0p), val_coord(seed, x1p, y0p), val_coord(seed, x2p, y0p), val_coord(seed, x3p, y0p), xs),
+        cubic_lerp(val_coord(seed, x0p, y1p), val_coord(seed, x1p, y1p), val_coord(seed, x2p, y1p), val_coord(seed, x3p, y1p), xs),
+        cubic_lerp(val_coord(seed, x0p, y2p), val_coord(seed, x1p, y2p), val_coord(seed, x2p, y2p), val_coord(seed, x3p, y2p), xs),
+        cubic_lerp(val_coord(seed, x0p, y3p), val_coord(seed, x1p, y3p), val_coord(seed, x2p, y3p), val_coord(seed, x3p, y3p), xs),
+        ys) * (1 / (1.5f * 1.5f));
+}
+
+template <NativeNoise::NoiseType TYPE>
+inline float single(int32_t seed, float x, float y) {
+    switch (TYPE) {
+        case NativeNoise::NOISE_SIMPLEX: return single_simplex(seed, x, y);
+        case NativeNoise::NOISE_PERLIN: return single_perlin(seed, x, y);
+        case NativeNoise::NOISE_VALUE: return single_value(seed, x, y);
+        case NativeNoise::NOISE_VALUE_CUBIC: return single_value_cubic(seed, x, y);
+        default: return 0.0f;
+    }
+}
+
+// Frequency scaling plus the OpenSimplex2 skew, applied once before the fractal
+template <NativeNoise::NoiseType TYPE>
+inline void transform_coordinate(const NativeNoise::Params& p, float& x, float& y) {
+    x = (x + p.offset_x) * p.frequency;
+    y = (y + p.offset_y) * p.frequency;
+
+    if (TYPE == NativeNoise::NOISE_SIMPLEX) {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float F2 = 0.5f * (SQRT3 - 1);
+        float t = (x + y) * F2;
+        x += t;
+        y += t;
+    }
+}
+
+template <NativeNoise::NoiseType TYPE>
+inline float fractal(const NativeNoise::Params& p, float x, float y) {
+    transform_coordinate<TYPE>(p, x, y);
+
+    int32_t seed = p.seed;
+    float sum = 0;
+    float amp = p.fractal_bounding;
+
+    switch (p.fractal_type) {
+        case NativeNoise::FRACTAL_FBM:
+            for (int i = 0; i < p.octaves; i++) {
+                float noise = single<TYPE>(seed++, x, y);
+                sum += noise * amp;
+                amp *= lerp(1.0f, std::min(noise + 1, 2.0f) * 0.5f, p.weighted_strength);
+                x *= p.lacunarity;
+                y *= p.lacunarity;
+                amp *= p.gain;
+            }
+            return sum;
+
+        case NativeNoise::FRACTAL_RIDGED:
+            for (int i = 0; i < p.octaves; i++) {
+                float noise = std::abs(single<TYPE>(seed++, x, y));
+                sum += (noise * -2 + 1) * amp;
+                amp *= lerp(1.0f, 1 - noise, p.weighted_strength);
+                x *= p.lacunarity;
+                y *= p.lacunarity;
+                amp *= p.gain;
+            }
+            return sum;
+
+        case NativeNoise::FRACTAL_PING_PONG:
+            for (int i = 0; i < p.octaves; i++) {
+                float noise = ping_pong((single<TYPE>(seed++, x, y) + 1) * p.ping_pong_strength);
+                sum += (noise - 0.5f) * 2 * amp;
+                amp *= lerp(1.0f, noise, p.weighted_strength);
+                x *= p.lacunarity;
+                y *= p.lacunarity;
+                amp *= p.gain;
+            }
+            return sum;
+
+        default:
+            return single<TYPE>(seed, x, y);
+    }
+}
+
+template <NativeNoise::NoiseType TYPE>
+void fractal_row(const NativeNoise::Params& p, const float* xs, float y, int count, float* out) {
+    for (int i = 0; i < count; ++i) {
+        out[i] = fractal<TYPE>(p, xs[i], y);
+    }
+}
+
+//------------------------------------------
+// Analytic derivatives. Each *_grad kernel returns the same value as its
+// plain counterpart and writes d/dx, d/dy with respect to its own inputs.
+//------------------------------------------
+
+inline float interp_hermite_deriv(float t) {
+    return 6 * t * (1 - t);
+}
+
+inline float interp_quintic_deriv(float t) {
+    return 30 * t * t * (t * (t - 2) + 1);
+}
+
+inline float cubic_lerp_deriv(float a, float b, float c, float d, float t) {
+    float p = (d - c) - (a - b);
+    return 3 * t * t * p + 2 * t * ((a - b) - p) + (c - a);
+}
+
+inline void grad_vector(int32_t seed, uint32_t x_primed, uint32_t y_primed, float& gx, float& gy) {
+    uint32_t hash = hash_coord(seed, x_primed, y_primed);
+    hash ^= hash >> 15;
+    hash &= 127 << 1;
+    gx = GRADIENTS_2D[hash];
+    gy = GRADIENTS_2D[hash | 1];
+}
+
+// One simplex corner: (a^4) * dot(g, d) with a = 0.5 - |d|^2. `a` is passed
+// in so each corner can use the exact expression single_simplex() uses.
+inline float simplex_corner_grad(int32_t seed, uint32_t x_primed, uint32_t y_primed, float xd, float yd, float a, float& dx, float& dy) {
+    if (a <= 0) {
+        dx = 0;
+        dy = 0;
+        return 0;
+    }
+
+    float gx, gy;
+    grad_vector(seed, x_primed, y_primed, gx, gy);
+    float g = xd * gx + yd * gy;
+    float a2 = a * a;
+    float a3 = a2 * a;
+    float a4 = a2 * a2;
+    dx = -8 * a3 * xd * g + a4 * gx;
+    dy = -8 * a3 * yd * g + a4 * gy;
+    return a4 * g;
+}
+
+// The skew applied in transform_coordinate and the unskew below cancel out,
+// so derivatives with respect to the corner offsets are derivatives with
+// respect to the (frequency-scaled) input coordinates.
+inline float single_simplex_grad(int32_t seed, float x, float y, float& dx, float& dy) {
+    const float SQRT3 = 1.7320508075688772935274463415059f;
+    const float G2 = (3 - SQRT3) / 6;
+
+    int32_t i = fast_floor(x);
+    int32_t j = fast_floor(y);
+    float xi = x - i;
+    float yi = y - j;
+
+    float t = (xi + yi) * G2;
+    float x0 = xi - t;
+    float y0 = yi - t;
+
+    uint32_t ip = (uint32_t)i * PRIME_X;
+    uint32_t jp = (uint32_t)j * PRIME_Y;
+
+    float dx0, dy0, dx1, dy1, dx2, dy2;
+    float a = 0.5f - x0 * x0 - y0 * y0;
+    float n0 = simplex_corner_grad(seed, ip, jp, x0, y0, a, dx0, dy0);
+
+    float c = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2)) * t + ((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2)) + a);
+    float n2 = simplex_corner_grad(seed, ip + PRIME_X, jp + PRIME_Y, x0 + (2 * G2 - 1), y0 + (2 * G2 - 1), c, dx2, dy2);
+
+    float n1;
+    if (y0 > x0) {
+        float x1 = x0 + G2;
+        float y1 = y0 + (G2 - 1);
+        n1 = simplex_corner_grad(seed, ip, jp + PRIME_Y, x1, y1, 0.5f - x1 * x1 - y1 * y1, dx1, dy1);
+    } else {
+        float x1 = x0 + (G2 - 1);
+        float y1 = y0 + G2;
+        n1 = simplex_corner_grad(seed, ip + PRIME_X, jp, x1, y1, 0.5f - x1 * x1 - y1 * y1, dx1, dy1);
+    }
+
+    const float SCALE = 99.83685446303647f;
+    dx = (dx0 + dx1 + dx2) * SCALE;
+    dy = (dy0 + dy1 + dy2) * SCALE;
+    return (n0 + n1 + n2) * SCALE;
+}
+
+inline float single_perlin_grad(int32_t seed, float x, float y, float& dx, float& dy) {
+    int32_t x0 = fast_floor(x);
+    int32_t y0 = fast_floor(y);
+
+    float xd0 = x - x0;
+    float yd0 = y - y0;
+    float xd1 = xd0 - 1;
+    float yd1 = yd0 - 1;
+
+    float xs = interp_quintic(xd0);
+    float ys = interp_quintic(yd0);
+    float dxs = interp_quintic_deriv(xd0);
+    float dys = interp_quintic_deriv(yd0);
+
+    uint32_t x0p = (uint32_t)x0 * PRIME_X;
+    uint32_t y0p = (uint32_t)y0 * PRIME_Y;
+    uint32_t x1p = x0p + PRIME_X;
+    uint32_t y1p = y0p + PRIME_Y;
+
+    float gx00, gy00, gx10, gy10, gx01, gy01, gx11, gy11;
+    grad_vector(seed, x0p, y0p, gx00, gy00);
+    grad_vector(seed, x1p, y0p, gx10, gy10);
+    grad_vector(seed, x0p, y1p, gx01, gy01);
+    grad_vector(seed, x1p, y1p, gx11, gy11);
+
+    float v00 = xd0 * gx00 + yd0 * gy00;
+    float v10 = xd1 * gx10 + yd0 * gy10;
+    float v01 = xd0 * gx01 + yd1 * gy01;
+    float v11 = xd1 * gx11 + yd1 * gy11;
+
+    float xf0 = lerp(v00, v10, xs);
+    float xf1 = lerp(v01, v11, xs);
+    float dxf0_dx = lerp(gx00, gx10, xs) + dxs * (v10 - v00);
+    float dxf1_dx = lerp(gx01, gx11, xs) + dxs * (v11 - v01);
+    float dxf0_dy = lerp(gy00, gy10, xs);
+    float dxf1_dy = lerp(gy01, gy11, xs);
+
+    const float SCALE = 1.4247691104677813f;
+    dx = lerp(dxf0_dx, dxf1_dx, ys) * SCALE;
+    dy = (lerp(dxf0_dy, dxf1_dy, ys) + dys * (xf1 - xf0)) * SCALE;
+    return lerp(xf0, xf1, ys) * SCALE;
+}
+
+inline float single_value_grad(int32_t seed, float x, float y, float& dx, float& dy) {
+    int32_t x0 = fast_floor(x);
+    int32_t y0 = fast_floor(y);
+
+    float tx = x - x0;
+    float ty = y - y0;
+    float xs = interp_hermite(tx);
+    float ys = interp_hermite(ty);
+
+    uint32_t x0p = (uint32_t)x0 * PRIME_X;
+    uint32_t y0p = (uint32_t)y0 * PRIME_Y;
+    uint32_t x1p = x0p + PRIME_X;
+    uint32_t y1p = y0p + PRIME_Y;
+
+    float v00 = val_coord(seed, x0p, y0p);
+    float v10 = val_coord(seed, x1p, y0p);
+    float v01 = val_coord(seed, x0p, y1p);
+    float v11 = val_coord(seed, x1p, y1p);
+
+    float xf0 = lerp(v00, v10, xs);
+    float xf1 = lerp(v01, v11, xs);
+
+    dx = interp_hermite_deriv(tx) * lerp(v10 - v00, v11 - v01, ys);
+    dy = interp_hermite_deriv(ty) * (xf1 - xf0);
+    return lerp(xf0, xf1, ys);
+}
+
+inline float single_value_cubic_grad(int32_t seed, float x, float y, float& dx, float& dy) {
+    int32_t x1 = fast_floor(x);
+    int32_t y1 = fast_floor(y);
+
+    float xs = x - x1;
+    float ys = y - y1;
+
+    uint32_t xp[4];
+    uint32_t yp[4];
+    xp[1] = (uint32_t)x1 * PRIME_X;
+    yp[1] = (uint32_t)y1 * PRIME_Y;
+    xp[0] = xp[1] - PRIME_X;
+    yp[0] = yp[1] - PRIME_Y;
+    xp[2] = xp[1] + PRIME_X;
+    yp[2] = yp[1] + PRIME_Y;
+    xp[3] = xp[1] + (PRIME_X << 1);
+    yp[3] = yp[1] + (PRIME_Y << 1);
+
+    float rows[4];
+    float row_dx[4];
+    for (int r = 0; r < 4; ++r) {
+        float a = val_coord(seed, xp[0], yp[r]);
+        float b = val_coord(seed, xp[1], yp[r]);
+        float c = val_coord(seed, xp[2], yp[r]);
+        float d = val_coord(seed, xp[3], yp[r]);
+        rows[r] = cubic_lerp(a, b, c, d, xs);
+        row_dx[r] = cubic_lerp_deriv(a, b, c, d, xs);
+    }
+
+    const float SCALE = 1 / (1.5f * 1.5f);
+    dx = cubic_lerp(row_dx[0], row_dx[1], row_dx[2], row_dx[3], ys) * SCALE;
+    dy = cubic_lerp_deriv(rows[0], rows[1], rows[2], rows[3], ys) * SCALE;
+    return cubic_lerp(rows[0], rows[1], rows[2], rows[3], ys) * SCALE;
+}
+
+template <NativeNoise::NoiseType TYPE>
+inline float single_grad(int32_t seed, float x, float y, float& dx, float& dy) {
+    switch (TYPE) {
+        case NativeNoise::NOISE_SIMPLEX: return single_simplex_grad(seed, x, y, dx, dy);
+        case NativeNoise::NOISE_PERLIN: return single_perlin_grad(seed, x, y, dx, dy);
+        case NativeNoise::NOISE_VALUE: return single_value_grad(seed, x, y, dx, dy);
+        case NativeNoise::NOISE_VALUE_CUBIC: return single_value_cubic_grad(seed, x, y, dx, dy);
+        default: dx = 0; dy = 0; return 0.0f;
+    }
+}
+
+// Same accumulation as fractal(), carrying the derivative of both the sum and
+// the (noise-dependent, when weighted_strength != 0) octave amplitude.
+template <NativeNoise::NoiseType TYPE>
+inline float fractal_grad(const NativeNoise::Params& p, float x, float y, float& r_dx, float& r_dy) {
+    transform_coordinate<TYPE>(p, x, y);
+
+    int32_t seed = p.seed;
+    float sum = 0, sum_dx = 0, sum_dy = 0;
+    float amp = p.fractal_bounding, amp_dx = 0, amp_dy = 0;
+    float coord_scale = 1.0f; // d(octave coordinate) / d(base coordinate)
+    float nx, ny;
+
+    switch (p.fractal_type) {
+        case NativeNoise::FRACTAL_FBM:
+            for (int i = 0; i < p.octaves; i++) {
+                float noise = single_grad<TYPE>(seed++, x, y, nx, ny);
+                nx *= coord_scale;
+                ny *= coord_scale;
+
+                sum += noise * amp;
+                sum_dx += nx * amp + noise * amp_dx;
+                sum_dy += ny * amp + noise * amp_dy;
+
+                bool saturated = noise + 1 >= 2.0f;
+                float weight = lerp(1.0f, std::min(noise + 1, 2.0f) * 0.5f, p.weighted_strength);
+                float weight_slope = saturated ? 0.0f : p.weighted_strength * 0.5f;
+                amp_dx = (amp_dx * weight + amp * weight_slope * nx) * p.gain;
+                amp_dy = (amp_dy * weight + amp * weight_slope * ny) * p.gain;
+                amp *= weight * p.gain;
+
+                x *= p.lacunarity;
+                y *= p.lacunarity;
+                coord_scale *= p.lacunarity;
+            }
+            break;
+
+        case NativeNoise::FRACTAL_RIDGED:
+            for (int i = 0; i < p.octaves; i++) {
+                float signed_noise = single_grad<TYPE>(seed++, x, y, nx, ny);
+                float sign = signed_noise < 0 ? -1.0f : 1.0f;
+                float noise = std::abs(signed_noise);
+                nx *= coord_scale * sign;
+                ny *= coord_scale * sign;
+
+                sum += (noise * -2 + 1) * amp;
+                sum_dx += -2 * nx * amp + (noise * -2 + 1) * amp_dx;
+                sum_dy += -2 * ny * amp + (noise * -2 + 1) * amp_dy;
+
+                float weight = lerp(1.0f, 1 - noise, p.weighted_strength);
+                amp_dx = (amp_dx * weight - amp * p.weighted_strength * nx) * p.gain;
+                amp_dy = (amp_dy * weight - amp * p.weighted_strength * ny) * p.gain;
+                amp *= weight * p.gain;
+
+                x *= p.lacunarity;
+                y *= p.lacunarity;
+                coord_scale *= p.lacunarity;
+            }
+            break;
+
+        case NativeNoise::FRACTAL_PING_PONG:
+            for (int i = 0; i < p.octaves; i++) {
+                float t = (single_grad<TYPE>(seed++, x, y, nx, ny) + 1) * p.ping_pong_strength;
+                t -= (int32_t)(t * 0.5f) * 2;
+                float slope = (t < 1 ? 1.0f : -1.0f) * p.ping_pong_strength * coord_scale;
+                float noise = t < 1 ? t : 2 - t;
+                nx *= slope;
+                ny *= slope;
+
+                sum += (noise - 0.5f) * 2 * amp;
+                sum_dx += 2 * nx * amp + (noise - 0.5f) * 2 * amp_dx;
+                sum_dy += 2 * ny * amp + (noise - 0.5f) * 2 * amp_dy;
+
+                float weight = lerp(1.0f, noise, p.weighted_strength);
+                amp_dx = (amp_dx * weight + amp * p.weighted_strength * nx) * p.gain;
+                amp_dy = (amp_dy * weight + amp * p.weighted_strength * ny) * p.gain;
+                amp *= weight * p.gain;
+
+                x *= p.lacunarity;
+                y *= p.lacunarity;
+                coord_scale *= p.lacunarity;
+            }
+            break;
+
+        default:
+            sum = single_grad<TYPE>(seed, x, y, sum_dx, sum_dy);
+            break;
+    }
+
+    // Back from noise space to world space. The simplex skew is accounted for
+    // in its kernel, leaving only the frequency.
+    r_dx = sum_dx * p.frequency;
+    r_dy = sum_dy * p.frequency;
+    return sum;
+}
+
+float calculate_fractal_bounding(int octaves, float gain) {
+    gain = std::abs(gain);
+    float amp = gain;
+    float amp_fractal = 1.0f;
+    for (int i = 1; i < octaves; i++) {
+        amp_fractal += amp;
+        amp *= gain;
+    }
+    return 1 / amp_fractal;
+}
+
+}
+
+bool NativeNoise::configure(const Ref<Noise>& p_noise) {
+    reset();
+
+    FastNoiseLite* fnl = Object::cast_to<FastNoiseLite>(p_noise.ptr());
+    if (!fnl || fnl->is_domain_warp_enabled()) {
+        return false;
+    }
+
+    Params p;
+    switch (fnl->get_noise_type()) {
+        case FastNoiseLite::TYPE_SIMPLEX: p.noise_type = NOISE_SIMPLEX; break;
+        case FastNoiseLite::TYPE_PERLIN: p.noise_type = NOISE_PERLIN; break;
+        case FastNoiseLite::TYPE_VALUE: p.noise_type = NOISE_VALUE; break;
+        case FastNoiseLite::TYPE_VALUE_CUBIC: p.noise_type = NOISE_VALUE_CUBIC; break;
+        default: return false; // Cellular and OpenSimplex2S are not mirrored
+    }
+
+    switch (fnl->get_fractal_type()) {
+        case FastNoiseLite::FRACTAL_NONE: p.fractal_type = FRACTAL_NONE; break;
+        case FastNoiseLite::FRACTAL_FBM: p.fractal_type = FRACTAL_FBM; break;
+        case FastNoiseLite::FRACTAL_RIDGED: p.fractal_type = FRACTAL_RIDGED; break;
+        case FastNoiseLite::FRACTAL_PING_PONG: p.fractal_type = FRACTAL_PING_PONG; break;
+        default: return false;
+    }
+
+    Vector3 offset = fnl->get_offset();
+    p.seed = fnl->get_seed();
+    p.frequency = fnl->get_frequency();
+    p.offset_x = offset.x;
+    p.offset_y = offset.y;
+    p.octaves = fnl->get_fractal_octaves();
+    p.lacunarity = fnl->get_fractal_lacunarity();
+    p.gain = fnl->get_fractal_gain();
+    p.weighted_strength = fnl->get_fractal_weighted_strength();
+    p.ping_pong_strength = fnl->get_fractal_ping_pong_strength();
+    p.fractal_bounding = calculate_fractal_bounding(p.octaves, p.gain);
+
+    params = p;
+    return true;
+}
+
+float NativeNoise::sample(float x, float y) const {
+    return sample_fractal(x, y);
+}
+
+float NativeNoise::sample_fractal(float x, float y) const {
+    switch (params.noise_type) {
+        case NOISE_SIMPLEX: return fractal<NOISE_SIMPLEX>(params, x, y);
+        case NOISE_PERLIN: return fractal<NOISE_PERLIN>(params, x, y);
+        case NOISE_VALUE: return fractal<NOISE_VALUE>(params, x, y);
+        case NOISE_VALUE_CUBIC: return fractal<NOISE_VALUE_CUBIC>(params, x, y);
+        default: return 0.0f;
+    }
+}
+
+float NativeNoise::sample_with_gradient(float x, float y, float& r_dx, float& r_dy) const {
+    switch (params.noise_type) {
+        case NOISE_SIMPLEX: return fractal_grad<NOISE_SIMPLEX>(params, x, y, r_dx, r_dy);
+        case NOISE_PERLIN: return fractal_grad<NOISE_PERLIN>(params, x, y, r_dx, r_dy);
+        case NOISE_VALUE: return fractal_grad<NOISE_VALUE>(params, x, y, r_dx, r_dy);
+        case NOISE_VALUE_CUBIC: return fractal_grad<NOISE_VALUE_CUBIC>(params, x, y, r_dx, r_dy);
+        default: r_dx = 0.0f; r_dy = 0.0f; return 0.0f;
+    }
+}
+
+void NativeNoise::sample_row(const float* xs, float y, int count, float* out) const {
+    // Dispatch once per row so the inner loop is a straight-line kernel
+    switch (params.noise_type) {
+        case NOISE_SIMPLEX: fractal_row<NOISE_SIMPLEX>(params, xs, y, count, out); break;
+        case NOISE_PERLIN: fractal_row<NOISE_PERLIN>(params, xs, y, count, out); break;
+        case NOISE_VALUE: fractal_row<NOISE_VALUE>(params, xs, y, count, out); break;
+        case NOISE_VALUE_CUBIC: fractal_row<NOISE_VALUE_CUBIC>(params, xs, y, count, out); break;
+        default: std::fill(out, out + count, 0.0f); break;
+    }
+}
+
+bool NativeNoise::validate(const Ref<Noise>& p_reference, int sample_count, float tolerance, float* r_max_error) const {
+    if (!is_valid() || p_reference.is_null()) {
+        return false;
+    }
+
+    // Spread the probes over a wide area, including negative coordinates, so
+    // floor/hash behaviour on both sides of the origin is exercised
+    float spread = 4.0f / std::max(params.frequency, 0.0001f);
+    float max_error = 0.0f;
+
+    for (int i = 0; i < sample_count; ++i) {
+        float x = (random_float(Vector2(i, 0.0f), 0x5eed) * 2.0f - 1.0f) * spread;
+        float y = (random_float(Vector2(0.0f, i), 0x5eed) * 2.0f - 1.0f) * spread;
+
+        float expected = p_reference->get_noise_2d(x, y);
+        float actual = sample(x, y);
+        max_error = std::max(max_error, std::abs(expected - actual));
+    }
+
+    if (r_max_error) {
+        *r_max_error = max_error;
+    }
+    return max_error <= tolerance;
+}
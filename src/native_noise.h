@@ -0,0 +1,89 @@
+//==========================================
+// native_noise.h - Native FastNoiseLite evaluator
+//==========================================
+#ifndef NATIVE_NOISE_H
+#define NATIVE_NOISE_H
+
+#include <godot_cpp/classes/noise.hpp>
+#include <cstdint>
+
+namespace godot {
+
+// Snapshot of a FastNoiseLite resource that can be evaluated without crossing
+// the GDExtension boundary. Mirrors the 2D code paths of FastNoiseLite for the
+// noise types we use; anything else (cellular, domain warp) stays unsupported
+// and callers fall back to Godot's get_noise_2d().
+class NativeNoise {
+public:
+    enum NoiseType {
+        NOISE_UNSUPPORTED,
+        NOISE_SIMPLEX,
+        NOISE_PERLIN,
+        NOISE_VALUE,
+        NOISE_VALUE_CUBIC
+    };
+
+    enum FractalType {
+        FRACTAL_NONE,
+        FRACTAL_FBM,
+        FRACTAL_RIDGED,
+        FRACTAL_PING_PONG
+    };
+
+    struct Params {
+        NoiseType noise_type = NOISE_UNSUPPORTED;
+        FractalType fractal_type = FRACTAL_NONE;
+        int32_t seed = 0;
+        float frequency = 0.01f;
+        float offset_x = 0.0f;
+        float offset_y = 0.0f;
+        int octaves = 1;
+        float lacunarity = 2.0f;
+        float gain = 0.5f;
+        float weighted_strength = 0.0f;
+        float ping_pong_strength = 2.0f;
+        float fractal_bounding = 1.0f;
+    };
+
+    // Snapshot the parameters of p_noise. Returns false (and leaves the
+    // snapshot invalid) if the resource is not a FastNoiseLite or uses a
+    // feature this evaluator does not implement.
+    bool configure(const Ref<Noise>& p_noise);
+    void reset() { params = Params(); }
+    bool is_valid() const { return params.noise_type != NOISE_UNSUPPORTED; }
+    const Params& get_params() const { return params; }
+
+    float sample(float x, float y) const;
+    // Value plus its analytic partial derivatives with respect to x and y
+    float sample_with_gradient(float x, float y, float& r_dx, float& r_dy) const;
+
+    // Evaluate a row of samples sharing the same y. Taking the x coordinates
+    // explicitly keeps results bit-identical to per-point sample() calls.
+    void sample_row(const float* xs, float y, int count, float* out) const;
+
+    // Compare against Godot's own evaluation at a deterministic set of points.
+    // Returns true if every sample is within `tolerance`; the largest observed
+    // difference is written to r_max_error when provided.
+    bool validate(const Ref<Noise>& p_reference, int sample_count, float tolerance, float* r_max_error = nullptr) const;
+
+private:
+    Params params;
+
+    float sample_fractal(float x, float y) const;
+};
+
+// Snapshots of the three height layers, published together with the lattice
+// rate each layer is evaluated at (see TerrainConfig::multi_rate_noise), so a
+// block never pairs one layer's noise with another version's rate
+struct NativeNoiseLayers {
+    NativeNoise continentalness;
+    NativeNoise peaks_and_valleys;
+    NativeNoise erosion;
+    int continentalness_rate = 1;
+    int peaks_and_valleys_rate = 1;
+    int erosion_rate = 1;
+};
+
+}
+
+#endif
@@ -0,0 +1,644 @@
+//==========================================
+// noise_program.cpp - Compiled form of a TerrainNoiseGraph
+//==========================================
+#include "noise_program.h"
+#include "noise_sampling.h"
+#include "terrain_noise_graph.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace godot;
+
+namespace {
+
+// Result of compiling one graph node: either a compile-time constant or an
+// SSA value produced by an instruction
+struct Value {
+    bool constant = false;
+    float number = 0.0f;
+    int ssa = -1;
+};
+
+bool is_constant(const Value& value, float number) {
+    return value.constant && value.number == number;
+}
+
+// A register of a gradient run: the value and its partial derivatives
+struct Dual {
+    float value;
+    Vector2 gradient;
+};
+
+}
+
+String NoiseProgram::compile(const Ref<TerrainNoiseGraph>& p_graph, const CompileOptions& p_options) {
+    *this = NoiseProgram();
+    spacing = p_options.spacing;
+
+    if (p_graph.is_null()) {
+        return "No graph assigned.";
+    }
+
+    int node_count = p_graph->get_node_count();
+    int output = p_graph->get_output_node();
+    if (output < 0 || output >= node_count) {
+        return "Output node " + String::num_int64(output) + " is out of range.";
+    }
+
+    std::vector<Ref<TerrainNoiseNode>> nodes(node_count);
+    for (int i = 0; i < node_count; ++i) {
+        nodes[i] = p_graph->get_node(i);
+    }
+
+    // Post-order walk from the output. Only reachable nodes are compiled
+    // (dead-node elimination); revisiting a node still on the stack is a cycle.
+    enum VisitState : uint8_t { UNVISITED, VISITING, DONE };
+    std::vector<uint8_t> state(node_count, UNVISITED);
+    std::vector<int> order;
+    std::vector<std::pair<int, int>> stack; // (node, next input to visit)
+    stack.emplace_back(output, 0);
+    state[output] = VISITING;
+
+    while (!stack.empty()) {
+        int index = stack.back().first;
+        int next = stack.back().second;
+        const Ref<TerrainNoiseNode>& node = nodes[index];
+        if (node.is_null()) {
+            return "Node " + String::num_int64(index) + " is empty.";
+        }
+
+        PackedInt32Array inputs = node->get_inputs();
+        if (next == 0) {
+            TerrainNoiseNode::Operation operation = node->get_operation();
+            if (operation < 0 || operation >= TerrainNoiseNode::OP_MAX_OPERATION) {
+                return "Node " + String::num_int64(index) + " has an unknown operation.";
+            }
+            int expected = TerrainNoiseNode::get_input_count(operation);
+            bool warped_noise = operation == TerrainNoiseNode::OP_NOISE && inputs.size() == 2;
+            if (inputs.size() != expected && !warped_noise) {
+                return "Node " + String::num_int64(index) + " expects " + String::num_int64(expected) + " inputs.";
+            }
+        }
+
+        if (next < inputs.size()) {
+            int input = inputs[next];
+            stack.back().second++;
+            if (input < 0 || input >= node_count) {
+                return "Node " + String::num_int64(index) + " references missing node " + String::num_int64(input) + ".";
+            }
+            if (state[input] == VISITING) {
+                return "The graph contains a cycle through node " + String::num_int64(input) + ".";
+            }
+            if (state[input] == UNVISITED) {
+                state[input] = VISITING;
+                stack.emplace_back(input, 0);
+            }
+        } else {
+            state[index] = DONE;
+            order.push_back(index);
+            stack.pop_back();
+        }
+    }
+
+    // Emit SSA instructions in dependency order, folding constants as we go
+    std::vector<Instruction> ssa_code;
+    std::vector<Value> values(node_count);
+    std::unordered_map<const Noise*, int> unwarped_noise_values;
+    int ssa_count = 0;
+
+    auto emit = [&](Opcode op, int a, int b, int c, int resource, float imm) {
+        Instruction instruction;
+        instruction.op = op;
+        instruction.dst = (uint16_t)ssa_count;
+        instruction.a = (uint16_t)std::max(a, 0);
+        instruction.b = (uint16_t)std::max(b, 0);
+        instruction.c = (uint16_t)std::max(c, 0);
+        instruction.resource = resource;
+        instruction.imm = imm;
+        ssa_code.push_back(instruction);
+
+        Value value;
+        value.ssa = ssa_count++;
+        return value;
+    };
+
+    auto materialize = [&](const Value& value) {
+        return value.constant ? emit(CODE_FILL, -1, -1, -1, -1, value.number).ssa : value.ssa;
+    };
+
+    auto constant = [](float number) {
+        Value value;
+        value.constant = true;
+        value.number = number;
+        return value;
+    };
+
+    for (int index : order) {
+        const Ref<TerrainNoiseNode>& node = nodes[index];
+        PackedInt32Array inputs = node->get_inputs();
+        int arity = std::min((int)inputs.size(), 3);
+        Value in[3];
+        bool all_constant = true;
+        for (int i = 0; i < arity; ++i) {
+            in[i] = values[inputs[i]];
+            all_constant = all_constant && in[i].constant;
+        }
+
+        Value result;
+        switch (node->get_operation()) {
+            case TerrainNoiseNode::OP_CONSTANT:
+                result = constant(node->get_value());
+                break;
+
+            case TerrainNoiseNode::OP_NOISE: {
+                Ref<Noise> noise = node->get_noise();
+                if (noise.is_null()) {
+                    return "Noise node " + String::num_int64(index) + " has no noise resource.";
+                }
+
+                // A zero warp strength is the same as no warp inputs
+                bool warped = arity == 2 && node->get_value() != 0.0f;
+                if (!warped) {
+                    auto existing = unwarped_noise_values.find(noise.ptr());
+                    if (existing != unwarped_noise_values.end()) {
+                        result.ssa = existing->second;
+                        break;
+                    }
+                }
+
+                NoiseSource source;
+                source.noise = noise;
+                if (p_options.use_native_noise && source.native.configure(noise) && p_options.validate_native_noise) {
+                    const int VALIDATION_SAMPLES = 256;
+                    float max_error = 0.0f;
+                    if (!source.native.validate(noise, VALIDATION_SAMPLES, p_options.native_noise_tolerance, &max_error)) {
+                        UtilityFunctions::push_warning("Native noise for graph node " + String::num_int64(index) +
+                                                       " differs from Godot by " + String::num(max_error) +
+                                                       ", falling back to Godot noise.");
+                        source.native.reset();
+                    }
+                }
+                if (!warped && p_options.rate_error_budget > 0.0f) {
+                    source.rate = choose_noise_rate(noise, spacing, p_options.rate_error_budget);
+                }
+                noises.push_back(source);
+                int resource = (int)noises.size() - 1;
+
+                if (warped) {
+                    int warp_x = materialize(in[0]);
+                    int warp_z = materialize(in[1]);
+                    result = emit(CODE_NOISE_WARPED, warp_x, warp_z, -1, resource, node->get_value());
+                } else {
+                    result = emit(CODE_NOISE, -1, -1, -1, resource, 0.0f);
+                    unwarped_noise_values[noise.ptr()] = result.ssa;
+                }
+                break;
+            }
+
+            case TerrainNoiseNode::OP_ADD:
+                if (all_constant) {
+                    result = constant(in[0].number + in[1].number);
+                } else if (is_constant(in[0], 0.0f)) {
+                    result = in[1];
+                } else if (is_constant(in[1], 0.0f)) {
+                    result = in[0];
+                } else {
+                    result = emit(CODE_ADD, materialize(in[0]), materialize(in[1]), -1, -1, 0.0f);
+                }
+                break;
+
+            case TerrainNoiseNode::OP_SUBTRACT:
+                if (all_constant) {
+                    result = constant(in[0].number - in[1].number);
+                } else if (!in[0].constant && in[0].ssa == in[1].ssa) {
+                    result = constant(0.0f);
+                } else if (is_constant(in[1], 0.0f)) {
+                    result = in[0];
+                } else {
+                    result = emit(CODE_SUBTRACT, materialize(in[0]), materialize(in[1]), -1, -1, 0.0f);
+                }
+                break;
+
+            case TerrainNoiseNode::OP_MULTIPLY:
+                if (all_constant) {
+                    result = constant(in[0].number * in[1].number);
+                } else if (is_constant(in[0], 0.0f) || is_constant(in[1], 0.0f)) {
+                    result = constant(0.0f);
+                } else if (is_constant(in[0], 1.0f)) {
+                    result = in[1];
+                } else if (is_constant(in[1], 1.0f)) {
+                    result = in[0];
+                } else {
+                    result = emit(CODE_MULTIPLY, materialize(in[0]), materialize(in[1]), -1, -1, 0.0f);
+                }
+                break;
+
+            case TerrainNoiseNode::OP_MIN:
+                result = all_constant ? constant(std::min(in[0].number, in[1].number))
+                                      : emit(CODE_MIN, materialize(in[0]), materialize(in[1]), -1, -1, 0.0f);
+                break;
+
+            case TerrainNoiseNode::OP_MAX:
+                result = all_constant ? constant(std::max(in[0].number, in[1].number))
+                                      : emit(CODE_MAX, materialize(in[0]), materialize(in[1]), -1, -1, 0.0f);
+                break;
+
+            case TerrainNoiseNode::OP_LERP:
+                if (all_constant) {
+                    result = constant(in[0].number + (in[1].number - in[0].number) * in[2].number);
+                } else if (is_constant(in[2], 0.0f)) {
+                    result = in[0];
+                } else if (is_constant(in[2], 1.0f)) {
+                    result = in[1];
+                } else {
+                    result = emit(CODE_LERP, materialize(in[0]), materialize(in[1]), materialize(in[2]), -1, 0.0f);
+                }
+                break;
+
+            case TerrainNoiseNode::OP_ABS:
+                result = all_constant ? constant(std::abs(in[0].number))
+                                      : emit(CODE_ABS, materialize(in[0]), -1, -1, -1, 0.0f);
+                break;
+
+            case TerrainNoiseNode::OP_RIDGE:
+                result = all_constant ? constant(1.0f - std::abs(in[0].number))
+                                      : emit(CODE_RIDGE, materialize(in[0]), -1, -1, -1, 0.0f);
+                break;
+
+            case TerrainNoiseNode::OP_NORMALIZE:
+                result = all_constant ? constant((in[0].number + 1.0f) * 0.5f)
+                                      : emit(CODE_NORMALIZE, materialize(in[0]), -1, -1, -1, 0.0f);
+                break;
+
+            case TerrainNoiseNode::OP_CURVE: {
+                CurveLUT lut;
+                lut.bake(node->get_curve());
+                if (all_constant) {
+                    result = constant(lut.sample(in[0].number));
+                } else {
+                    curves.push_back(lut);
+                    result = emit(CODE_CURVE, materialize(in[0]), -1, -1, (int)curves.size() - 1, 0.0f);
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+        values[index] = result;
+    }
+
+    const Value& output_value = values[output];
+    if (output_value.constant) {
+        output_is_constant = true;
+        output_constant = output_value.number;
+        noises.clear();
+        curves.clear();
+        valid = true;
+        return String();
+    }
+
+    // Folding leaves instructions behind whose results nothing reads any more
+    // (both operands of x * 0, the unused side of lerp(a, b, 0)). Keep only
+    // what the output depends on, with the noises and curves those use.
+    std::vector<bool> live(ssa_count, false);
+    live[output_value.ssa] = true;
+    for (int i = (int)ssa_code.size() - 1; i >= 0; --i) {
+        const Instruction& instruction = ssa_code[i];
+        if (!live[instruction.dst]) {
+            continue;
+        }
+        const uint16_t operands[3] = {instruction.a, instruction.b, instruction.c};
+        for (int k = 0; k < operand_count(instruction.op); ++k) {
+            live[operands[k]] = true;
+        }
+    }
+
+    std::vector<Instruction> live_code;
+    std::vector<NoiseSource> live_noises;
+    std::vector<CurveLUT> live_curves;
+    std::vector<int> renumbered(ssa_count, -1);
+    std::vector<int> noise_index(noises.size(), -1);
+    std::vector<int> curve_index(curves.size(), -1);
+    for (Instruction instruction : ssa_code) {
+        if (!live[instruction.dst]) {
+            continue;
+        }
+        uint16_t* operands[3] = {&instruction.a, &instruction.b, &instruction.c};
+        for (int k = 0; k < operand_count(instruction.op); ++k) {
+            *operands[k] = (uint16_t)renumbered[*operands[k]];
+        }
+        if (instruction.op == CODE_NOISE || instruction.op == CODE_NOISE_WARPED) {
+            int& index = noise_index[instruction.resource];
+            if (index < 0) {
+                index = (int)live_noises.size();
+                live_noises.push_back(noises[instruction.resource]);
+            }
+            instruction.resource = index;
+        } else if (instruction.op == CODE_CURVE) {
+            int& index = curve_index[instruction.resource];
+            if (index < 0) {
+                index = (int)live_curves.size();
+                live_curves.push_back(curves[instruction.resource]);
+            }
+            instruction.resource = index;
+        }
+        renumbered[instruction.dst] = (int)live_code.size();
+        instruction.dst = (uint16_t)live_code.size();
+        live_code.push_back(instruction);
+    }
+    int output_ssa = renumbered[output_value.ssa];
+    ssa_code = std::move(live_code);
+    ssa_count = (int)ssa_code.size();
+    noises = std::move(live_noises);
+    curves = std::move(live_curves);
+
+    // Register allocation: linear scan over the SSA stream. A value's register
+    // is released after its last reader, so it can be that reader's destination
+    // (every opcode reads element i before writing it).
+    std::vector<int> last_use(ssa_count, -1);
+    for (int i = 0; i < (int)ssa_code.size(); ++i) {
+        const Instruction& instruction = ssa_code[i];
+        const uint16_t operands[3] = {instruction.a, instruction.b, instruction.c};
+        for (int k = 0; k < operand_count(instruction.op); ++k) {
+            last_use[operands[k]] = i;
+        }
+    }
+    last_use[output_ssa] = (int)ssa_code.size();
+
+    std::vector<int> physical(ssa_count, -1);
+    std::vector<int> free_registers;
+    code.reserve(ssa_code.size());
+
+    for (int i = 0; i < (int)ssa_code.size(); ++i) {
+        Instruction instruction = ssa_code[i];
+        uint16_t operands[3] = {instruction.a, instruction.b, instruction.c};
+        int operand_count = NoiseProgram::operand_count(instruction.op);
+
+        for (int k = 0; k < operand_count; ++k) {
+            operands[k] = (uint16_t)physical[operands[k]];
+        }
+
+        // Release operands that die here (once each, even if read twice)
+        for (int k = 0; k < operand_count; ++k) {
+            int source = k == 0 ? ssa_code[i].a : (k == 1 ? ssa_code[i].b : ssa_code[i].c);
+            if (last_use[source] == i && physical[source] >= 0) {
+                free_registers.push_back(physical[source]);
+                last_use[source] = -1;
+            }
+        }
+
+        int destination;
+        if (!free_registers.empty()) {
+            destination = free_registers.back();
+            free_registers.pop_back();
+        } else {
+            destination = register_count++;
+        }
+        physical[instruction.dst] = destination;
+
+        instruction.dst = (uint16_t)destination;
+        instruction.a = operands[0];
+        instruction.b = operands[1];
+        instruction.c = operands[2];
+        code.push_back(instruction);
+    }
+
+    output_register = physical[output_ssa];
+    valid = true;
+    return String();
+}
+
+int NoiseProgram::operand_count(Opcode op) {
+    switch (op) {
+        case CODE_FILL:
+        case CODE_NOISE:
+            return 0;
+        case CODE_ABS:
+        case CODE_RIDGE:
+        case CODE_NORMALIZE:
+        case CODE_CURVE:
+            return 1;
+        case CODE_LERP:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+void NoiseProgram::execute_lattice(int lattice_x, int lattice_z, int count_x, int count_z, float* out, int out_stride) const {
+    if (!valid || output_is_constant) {
+        float fill = valid ? output_constant : 0.0f;
+        for (int z = 0; z < count_z; ++z) {
+            std::fill(out + z * out_stride, out + z * out_stride + count_x, fill);
+        }
+        return;
+    }
+
+    int count = count_x * count_z;
+    thread_local std::vector<float> scratch;
+    size_t needed = (size_t)register_count * count;
+    if (scratch.size() < needed) {
+        scratch.resize(needed);
+    }
+
+    Domain domain = {true, lattice_x, lattice_z, count_x, count_z, 0.0f, 0.0f};
+    run(domain, scratch.data(), count);
+
+    const float* result = scratch.data() + (size_t)output_register * count;
+    for (int z = 0; z < count_z; ++z) {
+        std::copy(result + z * count_x, result + (z + 1) * count_x, out + z * out_stride);
+    }
+}
+
+float NoiseProgram::execute_point(float world_x, float world_z) const {
+    if (!valid || output_is_constant) {
+        return valid ? output_constant : 0.0f;
+    }
+
+    thread_local std::vector<float> scratch;
+    if (scratch.size() < (size_t)register_count) {
+        scratch.resize(register_count);
+    }
+
+    Domain domain = {false, 0, 0, 1, 1, world_x, world_z};
+    run(domain, scratch.data(), 1);
+    return scratch[output_register];
+}
+
+float NoiseProgram::execute_point_with_gradient(float world_x, float world_z, Vector2& r_gradient) const {
+    r_gradient = Vector2(0.0f, 0.0f);
+    if (!valid || output_is_constant) {
+        return valid ? output_constant : 0.0f;
+    }
+
+    thread_local std::vector<Dual> scratch;
+    if (scratch.size() < (size_t)register_count) {
+        scratch.resize(register_count);
+    }
+
+    // Forward mode: each instruction computes its value exactly as run() does,
+    // and its gradient from the operands' by the matching derivative rule
+    for (const Instruction& instruction : code) {
+        Dual& dst = scratch[instruction.dst];
+        const Dual a = scratch[instruction.a];
+        const Dual b = scratch[instruction.b];
+        const Dual c = scratch[instruction.c];
+
+        switch (instruction.op) {
+            case CODE_FILL:
+                dst = {instruction.imm, Vector2(0.0f, 0.0f)};
+                break;
+            case CODE_NOISE:
+                dst.value = noise_with_gradient_at(noises[instruction.resource], world_x, world_z, dst.gradient);
+                break;
+            case CODE_NOISE_WARPED: {
+                // n(x + s * a, z + s * b): the warp offsets move with x and z too
+                float strength = instruction.imm;
+                Vector2 noise_gradient;
+                dst.value = noise_with_gradient_at(noises[instruction.resource], world_x + strength * a.value,
+                                                   world_z + strength * b.value, noise_gradient);
+                dst.gradient = Vector2(noise_gradient.x * (1.0f + strength * a.gradient.x) + noise_gradient.y * strength * b.gradient.x,
+                                       noise_gradient.x * strength * a.gradient.y + noise_gradient.y * (1.0f + strength * b.gradient.y));
+                break;
+            }
+            case CODE_ADD:
+                dst = {a.value + b.value, a.gradient + b.gradient};
+                break;
+            case CODE_SUBTRACT:
+                dst = {a.value - b.value, a.gradient - b.gradient};
+                break;
+            case CODE_MULTIPLY:
+                dst = {a.value * b.value, a.gradient * b.value + b.gradient * a.value};
+                break;
+            case CODE_MIN:
+                dst = b.value < a.value ? b : a;  // Same pick as std::min
+                break;
+            case CODE_MAX:
+                dst = a.value < b.value ? b : a;  // Same pick as std::max
+                break;
+            case CODE_LERP:
+                dst = {a.value + (b.value - a.value) * c.value,
+                       a.gradient + (b.gradient - a.gradient) * c.value + c.gradient * (b.value - a.value)};
+                break;
+            case CODE_ABS:
+                dst = {std::abs(a.value), a.value < 0.0f ? -a.gradient : a.gradient};
+                break;
+            case CODE_RIDGE:
+                dst = {1.0f - std::abs(a.value), a.value < 0.0f ? a.gradient : -a.gradient};
+                break;
+            case CODE_NORMALIZE:
+                dst = {(a.value + 1.0f) * 0.5f, a.gradient * 0.5f};
+                break;
+            case CODE_CURVE: {
+                float slope;
+                dst.value = curves[instruction.resource].sample_with_derivative(a.value, slope);
+                dst.gradient = a.gradient * slope;
+                break;
+            }
+        }
+    }
+
+    const Dual& result = scratch[output_register];
+    r_gradient = result.gradient;
+    return result.value;
+}
+
+float NoiseProgram::noise_at(const NoiseSource& source, float x, float z) const {
+    if (source.native.is_valid()) {
+        return source.native.sample(x, z);
+    }
+    return source.noise->get_noise_2d(x, z);
+}
+
+float NoiseProgram::noise_with_gradient_at(const NoiseSource& source, float x, float z, Vector2& r_gradient) const {
+    if (source.native.is_valid()) {
+        return source.native.sample_with_gradient(x, z, r_gradient.x, r_gradient.y);
+    }
+
+    // Godot's Noise has no derivative API; use central differences for this source only
+    const float EPSILON = 0.05f;
+    float dx = source.noise->get_noise_2d(x + EPSILON, z) - source.noise->get_noise_2d(x - EPSILON, z);
+    float dz = source.noise->get_noise_2d(x, z + EPSILON) - source.noise->get_noise_2d(x, z - EPSILON);
+    r_gradient = Vector2(dx, dz) / (2.0f * EPSILON);
+    return source.noise->get_noise_2d(x, z);
+}
+
+void NoiseProgram::run(const Domain& domain, float* registers, int count) const {
+    for (const Instruction& instruction : code) {
+        float* dst = registers + (size_t)instruction.dst * count;
+        const float* a = registers + (size_t)instruction.a * count;
+        const float* b = registers + (size_t)instruction.b * count;
+        const float* c = registers + (size_t)instruction.c * count;
+
+        switch (instruction.op) {
+            case CODE_FILL:
+                std::fill(dst, dst + count, instruction.imm);
+                break;
+
+            case CODE_NOISE: {
+                const NoiseSource& source = noises[instruction.resource];
+                if (domain.lattice) {
+                    sample_noise_block(source.native, source.noise, source.rate, spacing,
+                                       domain.lattice_x, domain.lattice_z, domain.count_x, domain.count_z, dst);
+                } else {
+                    dst[0] = noise_at(source, domain.point_x, domain.point_z);
+                }
+                break;
+            }
+
+            case CODE_NOISE_WARPED: {
+                const NoiseSource& source = noises[instruction.resource];
+                float strength = instruction.imm;
+                if (domain.lattice) {
+                    for (int z = 0; z < domain.count_z; ++z) {
+                        float world_z = (domain.lattice_z + z) * spacing;
+                        for (int x = 0; x < domain.count_x; ++x) {
+                            int i = z * domain.count_x + x;
+                            float world_x = (domain.lattice_x + x) * spacing;
+                            dst[i] = noise_at(source, world_x + strength * a[i], world_z + strength * b[i]);
+                        }
+                    }
+                } else {
+                    dst[0] = noise_at(source, domain.point_x + strength * a[0], domain.point_z + strength * b[0]);
+                }
+                break;
+            }
+
+            case CODE_ADD:
+                for (int i = 0; i < count; ++i) dst[i] = a[i] + b[i];
+                break;
+            case CODE_SUBTRACT:
+                for (int i = 0; i < count; ++i) dst[i] = a[i] - b[i];
+                break;
+            case CODE_MULTIPLY:
+                for (int i = 0; i < count; ++i) dst[i] = a[i] * b[i];
+                break;
+            case CODE_MIN:
+                for (int i = 0; i < count; ++i) dst[i] = std::min(a[i], b[i]);
+                break;
+            case CODE_MAX:
+                for (int i = 0; i < count; ++i) dst[i] = std::max(a[i], b[i]);
+                break;
+            case CODE_LERP:
+                for (int i = 0; i < count; ++i) dst[i] = a[i] + (b[i] - a[i]) * c[i];
+                break;
+            case CODE_ABS:
+                for (int i = 0; i < count; ++i) dst[i] = std::abs(a[i]);
+                break;
+            case CODE_RIDGE:
+                for (int i = 0; i < count; ++i) dst[i] = 1.0f - std::abs(a[i]);
+                break;
+            case CODE_NORMALIZE:
+                for (int i = 0; i < count; ++i) dst[i] = (a[i] + 1.0f) * 0.5f;
+                break;
+            case CODE_CURVE: {
+                const CurveLUT& lut = curves[instruction.resource];
+                for (int i = 0; i < count; ++i) dst[i] = lut.sample(a[i]);
+                break;
+            }
+        }
+    }
+}
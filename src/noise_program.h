@@ -0,0 +1,114 @@
+//==========================================
+// noise_program.h - Compiled form of a TerrainNoiseGraph
+//==========================================
+#ifndef NOISE_PROGRAM_H
+#define NOISE_PROGRAM_H
+
+#include "native_noise.h"
+#include "curve_lut.h"
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+class TerrainNoiseGraph;
+
+// Flat, register-based instruction stream evaluated over whole lattice blocks.
+// Compilation keeps only nodes reachable from the output, folds constant
+// subexpressions, drops instructions the folded output no longer reads, and
+// reuses registers once a value is dead, so running a
+// program allocates nothing beyond a per-thread scratch buffer that grows
+// once.
+class NoiseProgram {
+public:
+    struct CompileOptions {
+        float spacing = 1.0f;               // World distance between lattice samples
+        bool use_native_noise = true;
+        bool validate_native_noise = true;
+        float native_noise_tolerance = 0.0001f;
+        float rate_error_budget = 0.0f;     // Multi-rate budget for unwarped noise; 0 disables
+    };
+
+    // Compiles p_graph. Returns an empty string on success, or a description
+    // of the problem (the program is left empty in that case).
+    String compile(const Ref<TerrainNoiseGraph>& p_graph, const CompileOptions& p_options);
+
+    bool is_valid() const { return valid; }
+    int get_instruction_count() const { return (int)code.size(); }
+    int get_register_count() const { return register_count; }
+
+    // Evaluate count_x * count_z lattice samples (world position = lattice
+    // index * spacing) into out, honouring out_stride between rows
+    void execute_lattice(int lattice_x, int lattice_z, int count_x, int count_z, float* out, int out_stride) const;
+
+    // Evaluate a single arbitrary world position
+    float execute_point(float world_x, float world_z) const;
+    // Same value as execute_point(), plus its partial derivatives (d/dx, d/dz)
+    // from the same pass: every register carries its gradient alongside
+    float execute_point_with_gradient(float world_x, float world_z, Vector2& r_gradient) const;
+
+private:
+    enum Opcode : uint8_t {
+        CODE_FILL,         // dst = imm
+        CODE_NOISE,        // dst = noise(x, z)
+        CODE_NOISE_WARPED, // dst = noise(x + imm * a, z + imm * b)
+        CODE_ADD,
+        CODE_SUBTRACT,
+        CODE_MULTIPLY,
+        CODE_MIN,
+        CODE_MAX,
+        CODE_LERP,         // dst = a + (b - a) * c
+        CODE_ABS,
+        CODE_RIDGE,
+        CODE_NORMALIZE,
+        CODE_CURVE         // dst = curves[resource].sample(a)
+    };
+
+    struct Instruction {
+        Opcode op;
+        uint16_t dst;
+        uint16_t a;
+        uint16_t b;
+        uint16_t c;
+        int32_t resource;  // Index into noises or curves
+        float imm;
+    };
+
+    struct NoiseSource {
+        Ref<Noise> noise;
+        NativeNoise native;
+        int rate = 1;
+    };
+
+    // Where the samples of one execution are
+    struct Domain {
+        bool lattice;
+        int lattice_x;
+        int lattice_z;
+        int count_x;
+        int count_z;
+        float point_x;
+        float point_z;
+    };
+
+    bool valid = false;
+    float spacing = 1.0f;
+    std::vector<Instruction> code;
+    std::vector<NoiseSource> noises;
+    std::vector<CurveLUT> curves;
+    int register_count = 0;
+    int output_register = 0;
+    bool output_is_constant = false;
+    float output_constant = 0.0f;
+
+    static int operand_count(Opcode op);
+    void run(const Domain& domain, float* registers, int count) const;
+    float noise_at(const NoiseSource& source, float x, float z) const;
+    float noise_with_gradient_at(const NoiseSource& source, float x, float z, Vector2& r_gradient) const;
+};
+
+}
+
+#endif
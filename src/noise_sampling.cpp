@@ -0,0 +1,177 @@
+//==========================================
+// noise_sampling.cpp - Row and block noise evaluation
+//==========================================
+#include "noise_sampling.h"
+#include "utils.h"
+#include <godot_cpp/classes/fast_noise_lite.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace godot;
+
+static inline float catmull_rom(float p0, float p1, float p2, float p3, float t) {
+    return p1 + 0.5f * t * (p2 - p0 + t * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3 + t * (3.0f * (p1 - p2) + p3 - p0)));
+}
+
+// Worst-case Catmull-Rom error for a unit sinusoid with `cycles` periods per
+// sample, measured over a grid of phases and sub-sample offsets
+static float catmull_rom_sinusoid_error(float cycles) {
+    if (cycles >= 0.25f) {
+        return 2.0f; // Too few samples per period to reconstruct at all
+    }
+
+    const int STEPS = 16;
+    float worst = 0.0f;
+    for (int p = 0; p < STEPS; ++p) {
+        float phase = p / (float)STEPS;
+        auto wave = [cycles, phase](float i) { return std::sin(2.0f * (float)M_PI * (cycles * i + phase)); };
+        for (int o = 0; o < STEPS; ++o) {
+            float t = o / (float)STEPS;
+            float interpolated = catmull_rom(wave(-1.0f), wave(0.0f), wave(1.0f), wave(2.0f), t);
+            worst = std::max(worst, std::abs(interpolated - wave(t)));
+        }
+    }
+    return worst;
+}
+
+void godot::sample_noise_row(const NativeNoise& native, const Ref<Noise>& noise,
+                             const float* xs, float world_z, int count, float* out) {
+    if (native.is_valid()) {
+        native.sample_row(xs, world_z, count, out);
+        return;
+    }
+
+    // Fallback: one binding call per sample
+    for (int i = 0; i < count; ++i) {
+        out[i] = noise->get_noise_2d(xs[i], world_z);
+    }
+}
+
+void godot::sample_noise_block(const NativeNoise& native, const Ref<Noise>& noise, int rate, float spacing,
+                               int lattice_x, int lattice_z, int count_x, int count_z, float* out) {
+    if (rate <= 1) {
+        // Full rate: x coordinates are shared by every row, each row is evaluated at once
+        std::vector<float> xs(count_x);
+        for (int x = 0; x < count_x; ++x) {
+            xs[x] = (lattice_x + x) * spacing;
+        }
+        for (int z = 0; z < count_z; ++z) {
+            sample_noise_row(native, noise, xs.data(), (lattice_z + z) * spacing, count_x, out + z * count_x);
+        }
+        return;
+    }
+
+    // Coarse samples sit on every rate-th global lattice point, so any block
+    // upsamples from the same coarse values and tiles stay seamless.
+    // Catmull-Rom needs one coarse sample before and two after each span.
+    int coarse_x0 = floor_div(lattice_x, rate) - 1;
+    int coarse_z0 = floor_div(lattice_z, rate) - 1;
+    int coarse_count_x = floor_div(lattice_x + count_x - 1, rate) + 3 - coarse_x0;
+    int coarse_count_z = floor_div(lattice_z + count_z - 1, rate) + 3 - coarse_z0;
+
+    std::vector<float> coarse_xs(coarse_count_x);
+    for (int i = 0; i < coarse_count_x; ++i) {
+        coarse_xs[i] = ((coarse_x0 + i) * rate) * spacing;
+    }
+
+    std::vector<float> coarse(coarse_count_x * coarse_count_z);
+    for (int j = 0; j < coarse_count_z; ++j) {
+        float world_z = ((coarse_z0 + j) * rate) * spacing;
+        sample_noise_row(native, noise, coarse_xs.data(), world_z, coarse_count_x, coarse.data() + j * coarse_count_x);
+    }
+
+    // Horizontal pass: upsample every coarse row to the full-rate x positions
+    float inv_rate = 1.0f / rate;
+    std::vector<int> span_x(count_x);
+    std::vector<float> frac_x(count_x);
+    for (int x = 0; x < count_x; ++x) {
+        int cell = floor_div(lattice_x + x, rate);
+        span_x[x] = cell - coarse_x0;
+        frac_x[x] = (lattice_x + x - cell * rate) * inv_rate;
+    }
+
+    std::vector<float> horizontal(coarse_count_z * count_x);
+    for (int j = 0; j < coarse_count_z; ++j) {
+        const float* row = coarse.data() + j * coarse_count_x;
+        float* dst = horizontal.data() + j * count_x;
+        for (int x = 0; x < count_x; ++x) {
+            int i = span_x[x];
+            dst[x] = catmull_rom(row[i - 1], row[i], row[i + 1], row[i + 2], frac_x[x]);
+        }
+    }
+
+    // Vertical pass
+    for (int z = 0; z < count_z; ++z) {
+        int cell = floor_div(lattice_z + z, rate);
+        int j = cell - coarse_z0;
+        float t = (lattice_z + z - cell * rate) * inv_rate;
+
+        const float* r0 = horizontal.data() + (j - 1) * count_x;
+        const float* r1 = r0 + count_x;
+        const float* r2 = r1 + count_x;
+        const float* r3 = r2 + count_x;
+        float* dst = out + z * count_x;
+        for (int x = 0; x < count_x; ++x) {
+            dst[x] = catmull_rom(r0[x], r1[x], r2[x], r3[x], t);
+        }
+    }
+}
+
+int godot::choose_noise_rate(const Ref<Noise>& noise, float spacing, float error_budget) {
+    // Only smooth configurations upsample well: no cellular noise, no domain
+    // warp and no ridged/ping-pong creases
+    FastNoiseLite* fnl = Object::cast_to<FastNoiseLite>(noise.ptr());
+    if (!fnl || fnl->is_domain_warp_enabled()) {
+        return 1;
+    }
+    switch (fnl->get_noise_type()) {
+        case FastNoiseLite::TYPE_SIMPLEX:
+        case FastNoiseLite::TYPE_SIMPLEX_SMOOTH:
+        case FastNoiseLite::TYPE_PERLIN:
+        case FastNoiseLite::TYPE_VALUE:
+        case FastNoiseLite::TYPE_VALUE_CUBIC:
+            break;
+        default:
+            return 1;
+    }
+
+    int octaves = 1;
+    if (fnl->get_fractal_type() == FastNoiseLite::FRACTAL_FBM) {
+        octaves = fnl->get_fractal_octaves();
+    } else if (fnl->get_fractal_type() != FastNoiseLite::FRACTAL_NONE) {
+        return 1;
+    }
+
+    float gain = std::abs(fnl->get_fractal_gain());
+    float amplitude_sum = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < octaves; ++i) {
+        amplitude_sum += amplitude;
+        amplitude *= gain;
+    }
+
+    for (int rate = MAX_NOISE_RATE; rate > 1; rate /= 2) {
+        float coarse_spacing = spacing * rate;
+        float error = 0.0f;
+        float octave_amplitude = 1.0f;
+        float frequency = fnl->get_frequency();
+        for (int i = 0; i < octaves; ++i) {
+            // Gradient and value noise carry energy up to about twice the nominal frequency
+            error += octave_amplitude * catmull_rom_sinusoid_error(std::abs(2.0f * frequency * coarse_spacing));
+            octave_amplitude *= gain;
+            frequency *= fnl->get_fractal_lacunarity();
+        }
+
+        // Normalized like FastNoiseLite's fractal bounding; one pass per axis
+        error = 2.0f * error / amplitude_sum;
+        if (error <= error_budget) {
+            return rate;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,32 @@
+//==========================================
+// noise_sampling.h - Row and block noise evaluation
+//==========================================
+#ifndef NOISE_SAMPLING_H
+#define NOISE_SAMPLING_H
+
+#include "native_noise.h"
+#include <godot_cpp/classes/noise.hpp>
+
+namespace godot {
+
+static constexpr int MAX_NOISE_RATE = 8;
+
+// Evaluate a row sharing one y through `native` when it holds a valid
+// snapshot, otherwise through Godot's get_noise_2d()
+void sample_noise_row(const NativeNoise& native, const Ref<Noise>& noise,
+                      const float* xs, float world_z, int count, float* out);
+
+// Evaluate count_x * count_z lattice samples (world position = lattice index *
+// spacing) into a packed block. With rate > 1 only every rate-th global
+// lattice point is evaluated and the rest is upsampled bicubically, so results
+// never depend on where the block starts.
+void sample_noise_block(const NativeNoise& native, const Ref<Noise>& noise, int rate, float spacing,
+                        int lattice_x, int lattice_z, int count_x, int count_z, float* out);
+
+// Coarsest rate (1 = every sample, up to MAX_NOISE_RATE) whose bicubic
+// upsampling stays within error_budget (noise units) for these noise settings
+int choose_noise_rate(const Ref<Noise>& noise, float spacing, float error_budget);
+
+}
+
+#endif
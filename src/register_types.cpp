@@ -1,6 +1,8 @@
 #include "register_types.h"
 
 #include "terrain_generator.h"
+#include "terrain_noise_graph.h"
+#include "chunk_index_buffers.h"
 
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
@@ -13,6 +15,8 @@ void initialize_terrain_generator_module(ModuleInitializationLevel p_level) {
 		return;
 	}
 
+	GDREGISTER_CLASS(TerrainNoiseNode);
+	GDREGISTER_CLASS(TerrainNoiseGraph);
 	GDREGISTER_RUNTIME_CLASS(TerrainGenerator);
 }
 
@@ -20,6 +24,8 @@ void uninitialize_terrain_generator_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+
+	ChunkIndexBuffers::clear();
 }
 
 extern "C" {
@@ -0,0 +1,78 @@
+//==========================================
+// river_distance_field.cpp - Per-chunk rasterized river distances
+//==========================================
+#include "river_distance_field.h"
+#include "river_generator.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+void RiverDistanceField::reset(Vector2 p_origin, float p_step, int p_size, float p_max_distance) {
+    origin = p_origin;
+    step = p_step;
+    size = p_size;
+    max_distance = p_max_distance;
+    has_rivers = false;
+    segments.clear();
+
+    Texel far_texel;
+    far_texel.distance = max_distance;
+    far_texel.bank_distance = max_distance;
+    texels.assign(size * size, far_texel);
+}
+
+void RiverDistanceField::add_segment(const RiverSegment& segment) {
+    segments.push_back({segment.start, segment.end, segment.width});
+}
+
+float RiverDistanceField::sample_bank_distance(float world_x, float world_z) const {
+    if (size < 2) {
+        return max_distance;
+    }
+
+    float fx = (world_x - origin.x) / step;
+    float fz = (world_z - origin.y) / step;
+
+    if (fx >= 0.0f && fz >= 0.0f && fx <= size - 1 && fz <= size - 1) {
+        int x0 = std::min((int)fx, size - 2);
+        int z0 = std::min((int)fz, size - 2);
+        float tx = fx - x0;
+        float tz = fz - z0;
+
+        float top = texel(x0, z0).bank_distance + (texel(x0 + 1, z0).bank_distance - texel(x0, z0).bank_distance) * tx;
+        float bottom = texel(x0, z0 + 1).bank_distance + (texel(x0 + 1, z0 + 1).bank_distance - texel(x0, z0 + 1).bank_distance) * tx;
+        return top + (bottom - top) * tz;
+    }
+
+    // Outside the rasterized area (e.g. jittered foliage near the chunk edge)
+    Vector2 point(world_x, world_z);
+    float best = max_distance;
+    for (const Capsule& capsule : segments) {
+        Vector2 segment_vec = capsule.end - capsule.start;
+        float segment_length_sq = segment_vec.length_squared();
+        float t = 0.0f;
+        if (segment_length_sq >= 0.0001f) {
+            t = std::clamp((point - capsule.start).dot(segment_vec) / segment_length_sq, 0.0f, 1.0f);
+        }
+        float distance = point.distance_to(capsule.start + segment_vec * t);
+        best = std::min(best, distance - capsule.width * 0.5f);
+    }
+    return best;
+}
+
+Ref<Image> RiverDistanceField::create_image() const {
+    PackedByteArray data;
+    data.resize(size * size * 4 * sizeof(float));
+    float* out = reinterpret_cast<float*>(data.ptrw());
+
+    for (int i = 0; i < size * size; ++i) {
+        const Texel& source = texels[i];
+        out[i * 4 + 0] = source.distance;
+        out[i * 4 + 1] = source.width;
+        out[i * 4 + 2] = source.t;
+        out[i * 4 + 3] = source.carving;
+    }
+
+    return Image::create_from_data(size, size, false, Image::FORMAT_RGBAF, data);
+}
@@ -0,0 +1,72 @@
+//==========================================
+// river_distance_field.h - Per-chunk rasterized river distances
+//==========================================
+#ifndef RIVER_DISTANCE_FIELD_H
+#define RIVER_DISTANCE_FIELD_H
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <vector>
+
+namespace godot {
+
+struct RiverSegment;
+
+// Nearest-river data sampled on a chunk's extended vertex grid (one texel per
+// vertex, including the one-step border). Built once per chunk by
+// HeightSampler::build_river_distance_field() and shared by terrain carving
+// and foliage exclusion, so neither has to scan segment lists per sample.
+class RiverDistanceField {
+public:
+    struct Texel {
+        float distance = 0.0f;       // Distance to the nearest river centreline (clamped to max_distance)
+        float width = 0.0f;          // Width of that nearest segment
+        float t = 0.0f;              // Position along that segment (0 = start, 1 = end)
+        float bank_distance = 0.0f;  // min(distance - width / 2) over all segments, i.e. distance to the nearest bank
+        float carving = 0.0f;        // Accumulated carving depth to subtract from the terrain
+    };
+
+    RiverDistanceField() = default;
+
+    // Resets to an empty field covering size x size texels starting at origin
+    void reset(Vector2 p_origin, float p_step, int p_size, float p_max_distance);
+
+    bool is_empty() const { return !has_rivers; }
+    int get_size() const { return size; }
+    float get_step() const { return step; }
+
+    Texel& texel(int x, int z) { return texels[z * size + x]; }
+    const Texel& texel(int x, int z) const { return texels[z * size + x]; }
+    void mark_has_rivers() { has_rivers = true; }
+
+    // Remember a segment within reach of the field for exact queries outside it
+    void add_segment(const RiverSegment& segment);
+
+    // Distance from (x, z) to the nearest river bank. Bilinear inside the
+    // field (distance is 1-Lipschitz, so the error is below step * 0.71);
+    // exact against the stored segments outside it.
+    float sample_bank_distance(float world_x, float world_z) const;
+
+    // RGBA float image: R = distance, G = width, B = t, A = carving.
+    // Intended for water/terrain shaders.
+    Ref<Image> create_image() const;
+
+private:
+    Vector2 origin;
+    float step = 1.0f;
+    int size = 0;
+    float max_distance = 0.0f;
+    bool has_rivers = false;
+    std::vector<Texel> texels;
+
+    struct Capsule {
+        Vector2 start;
+        Vector2 end;
+        float width;
+    };
+    std::vector<Capsule> segments;
+};
+
+}
+
+#endif
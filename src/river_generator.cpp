@@ -107,7 +107,7 @@ std::vector<RiverSource> RiverGenerator::find_river_sources_in_region(Vector2i c
                     Vector2 test_pos(x, z);
 
                     if (should_place_river_source(test_pos)) {
-                        float height = height_sampler->sample_height(x, z);
+                        float height = height_sampler->sample_height_cached(x, z);
 
                         if (height >= MIN_SOURCE_HEIGHT) {
                             // Check if this position has a valid downhill path before placing a source
@@ -131,7 +131,7 @@ std::vector<RiverSource> RiverGenerator::find_river_sources_in_region(Vector2i c
 
             // If we found a valid spot in this grid cell, add it as a source
             if (found_valid_spot) {
-                float height = height_sampler->sample_height(best_position.x, best_position.y);
+                float height = height_sampler->sample_height_cached(best_position.x, best_position.y);
                 // Use grid coordinates to create a deterministic source ID
                 int deterministic_id = grid_x * 10000 + grid_z;
                 sources.push_back({best_position, height, deterministic_id});
@@ -230,7 +230,7 @@ std::vector<RiverSegment> RiverGenerator::get_river_segments_for_chunk(Vector2i
     return segments;
 }
 
-std::vector<RiverSegment> RiverGenerator::get_river_segments_for_carving(Vector2i chunk_pos) const {
+std::vector<RiverSegment> RiverGenerator::get_river_segments_for_carving(Vector2i chunk_pos, const CancellationToken* cancel) const {
     std::vector<RiverSegment> segments;
 
     // Use a much larger search radius for carving to ensure consistent results across chunks
@@ -243,7 +243,10 @@ std::vector<RiverSegment> RiverGenerator::get_river_segments_for_carving(Vector2
 
     for (const RiverSource& source : sources) {
         // Trace the river from this source
-        RiverPath river = trace_river_from_source(source);
+        RiverPath river = trace_river_from_source(source, cancel);
+        if (CancellationToken::is_cancelled(cancel)) {
+            return {};
+        }
 
         // Extract segments that could potentially affect this chunk (wider search)
         std::vector<RiverSegment> chunk_segments = extract_segments_for_carving(river, chunk_pos);
@@ -253,7 +256,7 @@ std::vector<RiverSegment> RiverGenerator::get_river_segments_for_carving(Vector2
     return segments;
 }
 
-std::vector<RiverSegment> RiverGenerator::get_river_segments_for_foliage(Vector2i chunk_pos) const {
+std::vector<RiverSegment> RiverGenerator::get_river_segments_for_foliage(Vector2i chunk_pos, const CancellationToken* cancel) const {
     std::vector<RiverSegment> segments;
 
     // Use a moderate search radius for foliage exclusion - larger than regular chunk search
@@ -264,7 +267,10 @@ std::vector<RiverSegment> RiverGenerator::get_river_segments_for_foliage(Vector2
 
     for (const RiverSource& source : sources) {
         // Trace the river from this source
-        RiverPath river = trace_river_from_source(source);
+        RiverPath river = trace_river_from_source(source, cancel);
+        if (CancellationToken::is_cancelled(cancel)) {
+            return {};
+        }
 
         // Extract segments that could potentially affect foliage in this chunk
         std::vector<RiverSegment> chunk_segments = extract_segments_for_carving(river, chunk_pos);
@@ -274,7 +280,19 @@ std::vector<RiverSegment> RiverGenerator::get_river_segments_for_foliage(Vector2
     return segments;
 }
 
-RiverPath RiverGenerator::trace_river_from_source(const RiverSource& source) const {
+void RiverGenerator::build_river_distance_field(Vector2i chunk_pos, RiverDistanceField& r_field,
+                                                const CancellationToken* cancel) const {
+    // The carving search covers the foliage one, so rivers are only traced once per chunk
+    std::vector<RiverSegment> segments = config->enable_river_carving
+        ? get_river_segments_for_carving(chunk_pos, cancel)
+        : get_river_segments_for_foliage(chunk_pos, cancel);
+    if (CancellationToken::is_cancelled(cancel)) {
+        return;
+    }
+    height_sampler->build_river_distance_field(chunk_pos, segments, r_field);
+}
+
+RiverPath RiverGenerator::trace_river_from_source(const RiverSource& source, const CancellationToken* cancel) const {
     RiverPath river;
     river.source_id = source.source_id;
     river.reaches_sea_level = false;
@@ -292,7 +310,11 @@ RiverPath RiverGenerator::trace_river_from_source(const RiverSource& source) con
     float current_search_radius = SEARCH_RADIUS;
     float tolerance_height_gain = 0.0f; // How much uphill we can tolerate
 
-    while (trace_count < MAX_TRACE_POINTS && current_height > SEA_LEVEL) {
+    while (trace_count < MAX_TRACE_POINTS && current_height > config->sea_level) {
+        if (CancellationToken::is_cancelled(cancel)) {
+            break;
+        }
+
         // Find the best direction with current constraints
         Vector2 next_direction = find_best_river_direction(current_pos, current_height, current_search_radius, 
                                                           tolerance_height_gain, last_direction);
@@ -339,7 +361,7 @@ RiverPath RiverGenerator::trace_river_from_source(const RiverSource& source) con
 
         // Move to next position
         Vector2 next_pos = current_pos + next_direction.normalized() * TRACE_STEP;
-        float next_height = height_sampler->sample_height(next_pos.x, next_pos.y);
+        float next_height = height_sampler->sample_height_cached(next_pos.x, next_pos.y);
 
         // Increase river width as it flows
         current_width += WIDTH_GROWTH_RATE * TRACE_STEP;
@@ -355,7 +377,7 @@ RiverPath RiverGenerator::trace_river_from_source(const RiverSource& source) con
     }
 
     // Check if we reached sea level
-    if (current_height <= SEA_LEVEL) {
+    if (current_height <= config->sea_level) {
         river.reaches_sea_level = true;
     }
 
@@ -374,7 +396,7 @@ Vector2 RiverGenerator::find_downhill_direction(Vector2 current_pos, float curre
         Vector2 direction(cos(angle), sin(angle));
         Vector2 test_pos = current_pos + direction * SEARCH_RADIUS;
 
-        float test_height = height_sampler->sample_height(test_pos.x, test_pos.y);
+        float test_height = height_sampler->sample_height_cached(test_pos.x, test_pos.y);
         float height_drop = current_height - test_height;
 
         // Only consider directions with meaningful downhill slope
@@ -402,7 +424,7 @@ Vector2 RiverGenerator::find_downhill_direction_adaptive(Vector2 current_pos, fl
         Vector2 direction(cos(angle), sin(angle));
         Vector2 test_pos = current_pos + direction * search_radius;
 
-        float test_height = height_sampler->sample_height(test_pos.x, test_pos.y);
+        float test_height = height_sampler->sample_height_cached(test_pos.x, test_pos.y);
         float height_drop = current_height - test_height;
 
         // Only consider directions with meaningful downhill slope
@@ -422,7 +444,7 @@ Vector2 RiverGenerator::find_downhill_direction_adaptive(Vector2 current_pos, fl
                 if (x == 0 && z == 0) continue; // Skip current position
 
                 Vector2 test_pos = current_pos + Vector2(x * grid_step, z * grid_step);
-                float test_height = height_sampler->sample_height(test_pos.x, test_pos.y);
+                float test_height = height_sampler->sample_height_cached(test_pos.x, test_pos.y);
                 float height_drop = current_height - test_height;
 
                 // Only consider meaningful downhill slopes
@@ -444,6 +466,26 @@ Vector2 RiverGenerator::find_best_river_direction(Vector2 current_pos, float cur
     const float MIN_MEANINGFUL_DROP = MIN_HEIGHT_DROP * 0.3f; // More lenient
     const float MAX_TURN_ANGLE = config->river_max_turn_angle * M_PI / 180.0f; // Convert to radians
 
+    // Fast path: follow steepest descent from the analytic gradient and only
+    // fall back to the ring search when that direction is blocked
+    Vector2 gradient;
+    height_sampler->sample_height_and_gradient(current_pos.x, current_pos.y, gradient);
+    if (gradient.length_squared() > 1e-8f) {
+        Vector2 direction = -gradient.normalized();
+        bool within_turn = true;
+        if (last_direction.length_squared() > 0.001f) {
+            float turn_angle = std::acos(std::max(-1.0f, std::min(1.0f, direction.dot(last_direction))));
+            within_turn = turn_angle <= MAX_TURN_ANGLE;
+        }
+        if (within_turn) {
+            Vector2 test_pos = current_pos + direction * search_radius;
+            float test_height = height_sampler->sample_height_cached(test_pos.x, test_pos.y);
+            if (current_height - test_height > MIN_MEANINGFUL_DROP) {
+                return direction;
+            }
+        }
+    }
+
     // Calculate number of samples based on search radius
     int num_samples = std::max(16, static_cast<int>(search_radius / SEARCH_RADIUS * 16));
     num_samples = std::min(num_samples, 32); // Cap for performance
@@ -462,7 +504,7 @@ Vector2 RiverGenerator::find_best_river_direction(Vector2 current_pos, float cur
         }
         
         Vector2 test_pos = current_pos + direction * search_radius;
-        float test_height = height_sampler->sample_height(test_pos.x, test_pos.y);
+        float test_height = height_sampler->sample_height_cached(test_pos.x, test_pos.y);
         float height_change = current_height - test_height;
 
         // Calculate score based on multiple factors
@@ -518,7 +560,7 @@ Vector2 RiverGenerator::find_best_river_direction(Vector2 current_pos, float cur
                 }
 
                 Vector2 test_pos = current_pos + Vector2(x * grid_step, z * grid_step);
-                float test_height = height_sampler->sample_height(test_pos.x, test_pos.y);
+                float test_height = height_sampler->sample_height_cached(test_pos.x, test_pos.y);
                 float height_change = current_height - test_height;
 
                 // More lenient scoring for grid search
@@ -731,7 +773,7 @@ MeshInstance3D* RiverGenerator::create_debug_river_segment(const RiverSegment& s
 
 // ========== Advanced River Mesh Generation ==========
 
-void RiverGenerator::add_river_meshes_to_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos) const {
+void RiverGenerator::add_river_meshes_to_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos, const CancellationToken* cancel) const {
     if (!chunk_mesh || !config->enable_river_mesh) return;
 
     // Find all river sources in a much larger area to catch rivers that pass through this chunk
@@ -745,7 +787,10 @@ void RiverGenerator::add_river_meshes_to_chunk(MeshInstance3D* chunk_mesh, Vecto
 
     for (const RiverSource& source : sources) {
         // Trace the complete river path for this source
-        RiverPath river = trace_river_from_source(source);
+        RiverPath river = trace_river_from_source(source, cancel);
+        if (CancellationToken::is_cancelled(cancel)) {
+            return;
+        }
         if (river.points.size() < 2) continue;
 
         // Check if this river passes through or near this chunk
@@ -816,8 +861,8 @@ Ref<ArrayMesh> RiverGenerator::generate_river_geometry(const RiverSegment& segme
     float length = segment.start.distance_to(segment.end);
     
     // Calculate water surface heights (flat along each segment)
-    float start_terrain_height = height_sampler->sample_height(segment.start.x, segment.start.y);
-    float end_terrain_height = height_sampler->sample_height(segment.end.x, segment.end.y);
+    float start_terrain_height = height_sampler->sample_height_cached(segment.start.x, segment.start.y);
+    float end_terrain_height = height_sampler->sample_height_cached(segment.end.x, segment.end.y);
     
     // Water surface sits at carved terrain height + offset
     float start_water_height = start_terrain_height + config->river_mesh_depth_offset;
@@ -1007,13 +1052,13 @@ Ref<ArrayMesh> RiverGenerator::generate_continuous_river_geometry(const RiverPat
         float half_width = river_width * 0.5f;
 
         // Sample the carved terrain height at multiple points for better alignment
-        float terrain_height = height_sampler->sample_height(point.world_position.x, point.world_position.y);
+        float terrain_height = height_sampler->sample_height_cached(point.world_position.x, point.world_position.y);
         
         // Also sample at the left and right edges to get a better sense of the carved area
         Vector2 left_sample_pos = point.world_position + perpendicular * (half_width * 0.8f);
         Vector2 right_sample_pos = point.world_position - perpendicular * (half_width * 0.8f);
-        float left_terrain_height = height_sampler->sample_height(left_sample_pos.x, left_sample_pos.y);
-        float right_terrain_height = height_sampler->sample_height(right_sample_pos.x, right_sample_pos.y);
+        float left_terrain_height = height_sampler->sample_height_cached(left_sample_pos.x, left_sample_pos.y);
+        float right_terrain_height = height_sampler->sample_height_cached(right_sample_pos.x, right_sample_pos.y);
         
         // Use the minimum height to ensure water doesn't float above any carved area
         float min_terrain_height = std::min({terrain_height, left_terrain_height, right_terrain_height});
@@ -6,6 +6,7 @@
 
 #include "terrain_config.h"
 #include "height_sampler.h"
+#include "cancellation_token.h"
 #include <vector>
 #include <godot_cpp/variant/vector2.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
@@ -52,7 +53,6 @@ private:
     static constexpr float SOURCE_SAMPLE_STEP = 30.0f;  // Distance between sample points
 
     // River tracing parameters
-    static constexpr float SEA_LEVEL = -15.0f;         // Height considered "sea level" (match your ocean)
     static constexpr float TRACE_STEP = 3.0f;          // Distance between river trace points (smaller for better pathfinding)
     static constexpr float SEARCH_RADIUS = 30.0f;      // Radius to search for downhill direction (larger for better pathfinding)
     static constexpr int MAX_TRACE_POINTS = 2000;      // Maximum points in a river path (increased)
@@ -66,8 +66,11 @@ public:
     // Main interface for chunk generation
     std::vector<RiverSource> get_river_sources_for_chunk(Vector2i chunk_pos) const;
     std::vector<RiverSegment> get_river_segments_for_chunk(Vector2i chunk_pos) const;
-    std::vector<RiverSegment> get_river_segments_for_carving(Vector2i chunk_pos) const;  // Larger search radius for carving
-    std::vector<RiverSegment> get_river_segments_for_foliage(Vector2i chunk_pos) const;  // Optimized search for foliage exclusion
+    // A cancelled token stops tracing early; the results are then incomplete and left empty
+    std::vector<RiverSegment> get_river_segments_for_carving(Vector2i chunk_pos, const CancellationToken* cancel = nullptr) const;  // Larger search radius for carving
+    std::vector<RiverSegment> get_river_segments_for_foliage(Vector2i chunk_pos, const CancellationToken* cancel = nullptr) const;  // Optimized search for foliage exclusion
+    void build_river_distance_field(Vector2i chunk_pos, RiverDistanceField& r_field,
+                                    const CancellationToken* cancel = nullptr) const;  // Shared by carving and foliage
 
     // Debug visualization
     void add_debug_sources_to_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos) const;
@@ -79,7 +82,7 @@ private:
     bool should_place_river_source(Vector2 world_pos) const;
 
     // River tracing helpers
-    RiverPath trace_river_from_source(const RiverSource& source) const;
+    RiverPath trace_river_from_source(const RiverSource& source, const CancellationToken* cancel = nullptr) const;
     Vector2 find_downhill_direction(Vector2 current_pos, float current_height) const;
     Vector2 find_downhill_direction_adaptive(Vector2 current_pos, float current_height, float search_radius) const;
     Vector2 find_best_river_direction(Vector2 current_pos, float current_height, float search_radius, 
@@ -95,7 +98,7 @@ private:
 
 public:
     // Advanced river mesh generation
-    void add_river_meshes_to_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos) const;
+    void add_river_meshes_to_chunk(MeshInstance3D* chunk_mesh, Vector2i chunk_pos, const CancellationToken* cancel = nullptr) const;
 
 private:
     // River mesh generation helpers
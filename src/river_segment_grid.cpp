@@ -0,0 +1,93 @@
+//==========================================
+// river_segment_grid.cpp - Per-chunk spatial index of river capsules
+//==========================================
+#include "river_segment_grid.h"
+#include "river_generator.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+static float distance_sq_to_segment(Vector2 point, Vector2 start, Vector2 end) {
+    Vector2 segment_vec = end - start;
+    float length_sq = segment_vec.length_squared();
+    float t = 0.0f;
+    if (length_sq > 0.0001f) {
+        t = std::clamp((point - start).dot(segment_vec) / length_sq, 0.0f, 1.0f);
+    }
+    return point.distance_squared_to(start + segment_vec * t);
+}
+
+RiverSegmentGrid::RiverSegmentGrid(const std::vector<RiverSegment>& segments, Vector2 region_min, Vector2 region_max,
+                                   float p_cell_size, float radius_multiplier, float radius_padding)
+    : origin(region_min), cell_size(p_cell_size), inv_cell_size(1.0f / p_cell_size) {
+    // floor + 1 so points lying exactly on region_max still map to a cell
+    cells_x = (int)std::floor((region_max.x - region_min.x) * inv_cell_size) + 1;
+    cells_z = (int)std::floor((region_max.y - region_min.y) * inv_cell_size) + 1;
+
+    int cell_count = cells_x * cells_z;
+    cell_start.assign(cell_count + 1, 0);
+
+    // A cell is touched if the capsule reaches any point of it; testing the
+    // cell centre against radius + half diagonal is conservative and cheap.
+    const float half_diagonal = cell_size * 0.70710678f;
+
+    // Two passes: count per cell, then fill. Candidate cells come from the
+    // capsule's bounding box clipped to the region.
+    std::vector<std::pair<uint32_t, uint32_t>> touched;  // (cell, segment)
+    for (uint32_t i = 0; i < segments.size(); ++i) {
+        const RiverSegment& segment = segments[i];
+        float radius = segment.width * radius_multiplier + radius_padding;
+
+        float min_x = std::min(segment.start.x, segment.end.x) - radius;
+        float max_x = std::max(segment.start.x, segment.end.x) + radius;
+        float min_z = std::min(segment.start.y, segment.end.y) - radius;
+        float max_z = std::max(segment.start.y, segment.end.y) + radius;
+        if (max_x < region_min.x || min_x > region_max.x || max_z < region_min.y || min_z > region_max.y) {
+            continue;
+        }
+
+        int cx0 = std::clamp((int)std::floor((min_x - origin.x) * inv_cell_size), 0, cells_x - 1);
+        int cx1 = std::clamp((int)std::floor((max_x - origin.x) * inv_cell_size), 0, cells_x - 1);
+        int cz0 = std::clamp((int)std::floor((min_z - origin.y) * inv_cell_size), 0, cells_z - 1);
+        int cz1 = std::clamp((int)std::floor((max_z - origin.y) * inv_cell_size), 0, cells_z - 1);
+
+        float reach = radius + half_diagonal;
+        float reach_sq = reach * reach;
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                Vector2 centre(origin.x + (cx + 0.5f) * cell_size, origin.y + (cz + 0.5f) * cell_size);
+                if (distance_sq_to_segment(centre, segment.start, segment.end) <= reach_sq) {
+                    uint32_t cell = cz * cells_x + cx;
+                    touched.emplace_back(cell, i);
+                    cell_start[cell + 1]++;
+                }
+            }
+        }
+    }
+
+    for (int c = 0; c < cell_count; ++c) {
+        cell_start[c + 1] += cell_start[c];
+    }
+
+    // Segments keep their original relative order within each cell, so the
+    // summed carving is independent of the grid layout
+    indices.resize(touched.size());
+    std::vector<uint32_t> cursor(cell_start.begin(), cell_start.end() - 1);
+    for (const auto& entry : touched) {
+        indices[cursor[entry.first]++] = entry.second;
+    }
+}
+
+void RiverSegmentGrid::query(float x, float z, const uint32_t*& r_begin, const uint32_t*& r_end) const {
+    int cx = (int)std::floor((x - origin.x) * inv_cell_size);
+    int cz = (int)std::floor((z - origin.y) * inv_cell_size);
+    if (cx < 0 || cz < 0 || cx >= cells_x || cz >= cells_z || indices.empty()) {
+        r_begin = r_end = nullptr;
+        return;
+    }
+
+    uint32_t cell = cz * cells_x + cx;
+    r_begin = indices.data() + cell_start[cell];
+    r_end = indices.data() + cell_start[cell + 1];
+}
@@ -0,0 +1,46 @@
+//==========================================
+// river_segment_grid.h - Per-chunk spatial index of river capsules
+//==========================================
+#ifndef RIVER_SEGMENT_GRID_H
+#define RIVER_SEGMENT_GRID_H
+
+#include <godot_cpp/variant/vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+struct RiverSegment;
+
+// Uniform grid over a rectangular region (usually one chunk's extended
+// vertex grid). Each river segment is treated as a capsule whose radius is its
+// radius of influence and is inserted only into the cells that capsule can reach,
+// so a query returns just the segments that may affect a point in that cell.
+class RiverSegmentGrid {
+public:
+    // Builds the index. Segments whose capsule misses the region are dropped.
+    // Capsule radius is RiverSegment::width * radius_multiplier + radius_padding.
+    RiverSegmentGrid(const std::vector<RiverSegment>& segments, Vector2 region_min, Vector2 region_max,
+                     float cell_size, float radius_multiplier, float radius_padding = 0.0f);
+
+    bool is_empty() const { return indices.empty(); }
+
+    // Indices into the original segment list for the cell containing (x, z).
+    // Points outside the region return an empty range.
+    void query(float x, float z, const uint32_t*& r_begin, const uint32_t*& r_end) const;
+
+private:
+    Vector2 origin;
+    float cell_size;
+    float inv_cell_size;
+    int cells_x;
+    int cells_z;
+
+    // Compressed rows: segments of cell c are indices[cell_start[c] .. cell_start[c + 1])
+    std::vector<uint32_t> cell_start;
+    std::vector<uint32_t> indices;
+};
+
+}
+
+#endif
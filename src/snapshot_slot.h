@@ -0,0 +1,119 @@
+//==========================================
+// snapshot_slot.h - Immutable data shared with sampling threads
+//==========================================
+#ifndef SNAPSHOT_SLOT_H
+#define SNAPSHOT_SLOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+// Frees replaced snapshots once no generation job can still be reading them.
+// Jobs read inside a ReadScope; the main thread publishes, reads without one
+// and frees. Scopes count themselves under the current epoch's parity. A
+// version retired before the epoch moves on is freed once the previous
+// parity has drained, so a job that runs forever only holds back what was
+// retired while it was open, and nothing waits on the main thread.
+class SnapshotDomain {
+public:
+    class ReadScope {
+    public:
+        explicit ReadScope(const SnapshotDomain& p_domain) : domain(p_domain) {
+            for (;;) {
+                uint64_t epoch = domain.epoch.load();
+                parity = (int)(epoch & 1);
+                domain.readers[parity].fetch_add(1);
+                // A scope counted under an epoch that already moved on would
+                // not hold back what the new one retires
+                if (domain.epoch.load() == epoch) {
+                    break;
+                }
+                domain.readers[parity].fetch_sub(1);
+            }
+        }
+        ~ReadScope() { domain.readers[parity].fetch_sub(1, std::memory_order_release); }
+
+        ReadScope(const ReadScope&) = delete;
+        ReadScope& operator=(const ReadScope&) = delete;
+
+    private:
+        const SnapshotDomain& domain;
+        int parity = 0;
+    };
+
+    SnapshotDomain() = default;
+    SnapshotDomain(const SnapshotDomain&) = delete;
+    SnapshotDomain& operator=(const SnapshotDomain&) = delete;
+
+    // Main thread. Keeps p_value alive until every scope open now has closed.
+    void retire(std::shared_ptr<const void> p_value) {
+        retired.push_back(std::move(p_value));
+        collect();
+    }
+
+    // Main thread. Frees whatever no scope can hold any more; called every frame.
+    void collect() {
+        if (!draining.empty()) {
+            if (readers[(epoch.load() - 1) & 1].load() != 0) {
+                return;
+            }
+            draining.clear();
+        }
+        if (retired.empty()) {
+            return;
+        }
+
+        // Scopes opened from here on can only see what is published now
+        draining.swap(retired);
+        uint64_t previous = epoch.fetch_add(1);
+        if (readers[previous & 1].load() == 0) {
+            draining.clear();
+        }
+    }
+
+    // Main thread. Versions retired but not yet freed.
+    size_t get_pending_count() const { return retired.size() + draining.size(); }
+
+private:
+    mutable std::atomic<uint64_t> epoch{0};
+    mutable std::atomic<int> readers[2] = {};
+    std::vector<std::shared_ptr<const void>> retired;   // Since the epoch last moved on
+    std::vector<std::shared_ptr<const void>> draining;  // Waiting for the previous epoch's scopes
+};
+
+// Holds the current version of data that the main thread rebuilds and every
+// sampling thread reads, such as baked noise or curves. Readers pay one
+// atomic load per get() and never see a half-built value. Replaced versions
+// are retired into the domain, because a job may still be using one.
+template <class T>
+class SnapshotSlot {
+public:
+    explicit SnapshotSlot(SnapshotDomain& p_domain) : domain(p_domain) {}
+    SnapshotSlot(const SnapshotSlot&) = delete;
+    SnapshotSlot& operator=(const SnapshotSlot&) = delete;
+
+    // Any thread; jobs only inside a ReadScope. Null until the first set().
+    const T* get() const { return current.load(std::memory_order_acquire); }
+
+    // Main thread. Publishes p_value; nothing may change it afterwards.
+    void set(std::unique_ptr<const T> p_value) {
+        std::shared_ptr<const T> replaced = std::move(latest);
+        latest = std::move(p_value);
+        current.store(latest.get(), std::memory_order_release);
+        if (replaced) {
+            domain.retire(std::move(replaced));
+        }
+    }
+
+private:
+    SnapshotDomain& domain;
+    std::atomic<const T*> current{nullptr};
+    std::shared_ptr<const T> latest;
+};
+
+}
+
+#endif
@@ -10,6 +10,12 @@
 #include <godot_cpp/classes/curve.hpp>
 #include <godot_cpp/classes/material.hpp>
 #include <godot_cpp/classes/packed_scene.hpp>
+#include "native_noise.h"
+#include "curve_lut.h"
+#include "carving_falloff_lut.h"
+#include "terrain_noise_graph.h"
+#include "noise_program.h"
+#include "snapshot_slot.h"
 
 namespace godot {
 
@@ -28,6 +34,84 @@ struct TerrainConfig {
     Ref<Curve> peaks_and_valleys_curve;
     Ref<Curve> erosion_curve;
 
+    // Replaced snapshots below are freed through this once no generation job
+    // can still be reading them; TerrainGenerator collects every frame
+    SnapshotDomain snapshots;
+
+    // Baked versions of the curves above, rebuilt and republished by
+    // TerrainGenerator whenever a curve changes. Unset curves bake to identity.
+    SnapshotSlot<CurveLUTs> curve_luts{snapshots};
+
+    // Native snapshots of the three noise layers, rebuilt and republished by
+    // TerrainGenerator whenever a texture changes. Invalid snapshots fall back
+    // to Godot's noise.
+    bool use_native_noise = true;
+    bool validate_native_noise = true;         // Compare against Godot's noise before trusting a snapshot
+    float native_noise_tolerance = 0.0001f;    // Maximum allowed difference during validation
+    SnapshotSlot<NativeNoiseLayers> native_noise{snapshots};
+
+    // Shared height tile cache (see HeightTileCache); 0 disables it
+    int height_cache_size_mb = 64;
+
+    // Multi-rate noise: low-frequency layers are evaluated on a coarser lattice
+    // (every `rate`-th sample) and upsampled bicubically. Rates are derived from
+    // the FastNoiseLite settings so the upsampling error stays within the budget,
+    // and published with the native_noise snapshot.
+    bool multi_rate_noise = true;
+    float multi_rate_error_budget = 0.002f;   // Max interpolation error, in noise units ([-1, 1] range)
+
+    // Optional noise graph replacing the three-layer sum above. The compiled
+    // program is swapped in by TerrainGenerator whenever the graph changes;
+    // loader threads keep the program they started a block with.
+    Ref<TerrainNoiseGraph> noise_graph;
+    SnapshotSlot<NoiseProgram> noise_program{snapshots};
+
+    // Chunk LOD: level L meshes every 2^L-th lattice sample. Chunks closer than
+    // lod_distance chunks to the origin use level 0, and each further level
+    // covers twice the distance of the one before it. Levels are capped so
+    // segment_count stays divisible by 2^L.
+    int lod_levels = 4;                        // 1 disables LOD
+    int lod_distance = 3;
+
+    // Drop mesh vertices whose removal moves the surface by less than this
+    // many world units (doubled per LOD level); 0 keeps the full grid
+    float mesh_simplification_tolerance = 0.0f;
+
+    // Draw every chunk with a shared grid displaced in the terrain shader from
+    // a per-chunk height tile, instead of building a vertex mesh per chunk
+    bool gpu_heightmap = false;
+
+    // Draw the terrain as a geometry clipmap around the origin instead of one
+    // surface per chunk; chunks still stream foliage. The clipmap samples the
+    // uncarved height, so river meshes and debug segments are not built in
+    // this mode: they would float above the ground they were meant to cut.
+    bool clipmap_mode = false;
+    int clipmap_levels = 6;
+    int clipmap_size = 62;                     // Cells per side of every level, rounded down to 4k - 2
+    int clipmap_updates_per_frame = 16;        // Rows/columns resampled per frame, all levels together
+
+    // Load order: candidates are ordered by the estimated time until they can
+    // be on screen, and chunks are prefetched where the origin is heading
+    float prefetch_time = 1.5f;                // Seconds of origin motion to load ahead of; 0 disables prefetch
+    float offscreen_chunk_delay = 2.0f;        // Added to chunks outside the camera's view cone
+
+    // Unloading lags loading, so an origin idling on a chunk boundary does not
+    // regenerate the same chunks over and over
+    int unload_margin = 1;                     // Chunks past view_distance before a chunk counts as out of range
+    float unload_linger_time = 2.0f;           // Seconds out of range before it is unloaded
+
+    // Main-thread time per frame for adding, re-LODing and removing chunks;
+    // whatever does not fit carries over to the next frame. 0 means unlimited.
+    int chunk_integration_budget_usec = 2000;
+
+    // Worker threads generating chunks; 0 uses one per core, minus one for the main thread
+    int generation_threads = 0;
+
+    // Height of the ocean plane; rivers end here. Chunks entirely below it can
+    // be left without a terrain mesh when the water hides them.
+    float sea_level = -15.0f;
+    bool skip_underwater_chunks = false;
+
     Ref<Material> terrain_material;
     Ref<PackedScene> foliage_scene;
 
@@ -37,6 +121,7 @@ struct TerrainConfig {
     float river_carving_width_multiplier = 3.0f; // How wide the carving effect extends beyond river width
     float river_carving_smoothness = 2.0f;     // Controls the smoothness of the carving (higher = smoother)
     float river_uphill_carving_multiplier = 2.0f; // How much deeper to carve when going uphill (compensation factor)
+    SnapshotSlot<CarvingFalloffLUT> carving_falloff_lut{snapshots}; // Baked from river_carving_smoothness
     
     // River mesh generation parameters
     bool enable_river_mesh = true;             // Generate 3D river mesh instead of flat debug quads
@@ -55,6 +140,22 @@ struct TerrainConfig {
     float foliage_river_exclusion_radius = 8.0f; // How far from rivers to exclude foliage
 };
 
+// Mesh resolution of a chunk. Each edge uses the coarser of the chunk's and
+// the neighbour's level, so both sides of a shared edge match exactly.
+struct ChunkLod {
+    enum Edge { EDGE_NEG_X, EDGE_POS_X, EDGE_NEG_Z, EDGE_POS_Z, EDGE_MAX };
+
+    int level = 0;
+    int edge_levels[EDGE_MAX] = {0, 0, 0, 0};
+
+    bool operator==(const ChunkLod& other) const {
+        return level == other.level &&
+               edge_levels[0] == other.edge_levels[0] && edge_levels[1] == other.edge_levels[1] &&
+               edge_levels[2] == other.edge_levels[2] && edge_levels[3] == other.edge_levels[3];
+    }
+    bool operator!=(const ChunkLod& other) const { return !(*this == other); }
+};
+
 // Hash function for Vector2i
 struct Vector2iHash {
     size_t operator()(const Vector2i &v) const {
@@ -2,8 +2,14 @@
 // terrain_generator.cpp - Complete implementation
 //==========================================
 #include "terrain_generator.h"
+#include "noise_sampling.h"
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <algorithm>
+#include <cmath>
 
 using namespace godot;
 
@@ -44,6 +50,11 @@ void TerrainGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_erosion_curve"), &TerrainGenerator::get_erosion_curve);
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "erosion_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"), "set_erosion_curve", "get_erosion_curve");
 
+    // Optional node graph replacing the continentalness/peaks/erosion sum
+    ClassDB::bind_method(D_METHOD("set_noise_graph", "_noise_graph"), &TerrainGenerator::set_noise_graph);
+    ClassDB::bind_method(D_METHOD("get_noise_graph"), &TerrainGenerator::get_noise_graph);
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "noise_graph", PROPERTY_HINT_RESOURCE_TYPE, "TerrainNoiseGraph"), "set_noise_graph", "get_noise_graph");
+
     ClassDB::bind_method(D_METHOD("set_height_scale", "_height_scale"), &TerrainGenerator::set_height_scale);
     ClassDB::bind_method(D_METHOD("get_height_scale"), &TerrainGenerator::get_height_scale);
     ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "height_scale", PROPERTY_HINT_RANGE, "0.1, 100.0, 0.01"), "set_height_scale", "get_height_scale");
@@ -56,6 +67,70 @@ void TerrainGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_view_distance"), &TerrainGenerator::get_view_distance);
     ADD_PROPERTY(PropertyInfo(Variant::INT, "_view_distance", PROPERTY_HINT_RANGE, "1, 100, 1"), "set_view_distance", "get_view_distance");
 
+    ClassDB::bind_method(D_METHOD("set_generation_threads", "_generation_threads"), &TerrainGenerator::set_generation_threads);
+    ClassDB::bind_method(D_METHOD("get_generation_threads"), &TerrainGenerator::get_generation_threads);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "generation_threads", PROPERTY_HINT_RANGE, "0, 64, 1"), "set_generation_threads", "get_generation_threads");
+
+    ClassDB::bind_method(D_METHOD("set_chunk_integration_budget_usec", "_chunk_integration_budget_usec"), &TerrainGenerator::set_chunk_integration_budget_usec);
+    ClassDB::bind_method(D_METHOD("get_chunk_integration_budget_usec"), &TerrainGenerator::get_chunk_integration_budget_usec);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_integration_budget_usec", PROPERTY_HINT_RANGE, "0, 20000, 100"), "set_chunk_integration_budget_usec", "get_chunk_integration_budget_usec");
+
+    ClassDB::bind_method(D_METHOD("set_prefetch_time", "_prefetch_time"), &TerrainGenerator::set_prefetch_time);
+    ClassDB::bind_method(D_METHOD("get_prefetch_time"), &TerrainGenerator::get_prefetch_time);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "prefetch_time", PROPERTY_HINT_RANGE, "0.0, 10.0, 0.1"), "set_prefetch_time", "get_prefetch_time");
+
+    ClassDB::bind_method(D_METHOD("set_offscreen_chunk_delay", "_offscreen_chunk_delay"), &TerrainGenerator::set_offscreen_chunk_delay);
+    ClassDB::bind_method(D_METHOD("get_offscreen_chunk_delay"), &TerrainGenerator::get_offscreen_chunk_delay);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "offscreen_chunk_delay", PROPERTY_HINT_RANGE, "0.0, 5.0, 0.05"), "set_offscreen_chunk_delay", "get_offscreen_chunk_delay");
+
+    ClassDB::bind_method(D_METHOD("set_unload_margin", "_unload_margin"), &TerrainGenerator::set_unload_margin);
+    ClassDB::bind_method(D_METHOD("get_unload_margin"), &TerrainGenerator::get_unload_margin);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "unload_margin", PROPERTY_HINT_RANGE, "0, 8, 1"), "set_unload_margin", "get_unload_margin");
+
+    ClassDB::bind_method(D_METHOD("set_unload_linger_time", "_unload_linger_time"), &TerrainGenerator::set_unload_linger_time);
+    ClassDB::bind_method(D_METHOD("get_unload_linger_time"), &TerrainGenerator::get_unload_linger_time);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "unload_linger_time", PROPERTY_HINT_RANGE, "0.0, 30.0, 0.1"), "set_unload_linger_time", "get_unload_linger_time");
+
+    ClassDB::bind_method(D_METHOD("set_lod_levels", "_lod_levels"), &TerrainGenerator::set_lod_levels);
+    ClassDB::bind_method(D_METHOD("get_lod_levels"), &TerrainGenerator::get_lod_levels);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_levels", PROPERTY_HINT_RANGE, "1, 8, 1"), "set_lod_levels", "get_lod_levels");
+
+    ClassDB::bind_method(D_METHOD("set_lod_distance", "_lod_distance"), &TerrainGenerator::set_lod_distance);
+    ClassDB::bind_method(D_METHOD("get_lod_distance"), &TerrainGenerator::get_lod_distance);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_distance", PROPERTY_HINT_RANGE, "1, 100, 1"), "set_lod_distance", "get_lod_distance");
+
+    ClassDB::bind_method(D_METHOD("set_mesh_simplification_tolerance", "_mesh_simplification_tolerance"), &TerrainGenerator::set_mesh_simplification_tolerance);
+    ClassDB::bind_method(D_METHOD("get_mesh_simplification_tolerance"), &TerrainGenerator::get_mesh_simplification_tolerance);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "mesh_simplification_tolerance", PROPERTY_HINT_RANGE, "0.0, 5.0, 0.01"), "set_mesh_simplification_tolerance", "get_mesh_simplification_tolerance");
+
+    ClassDB::bind_method(D_METHOD("set_gpu_heightmap", "_gpu_heightmap"), &TerrainGenerator::set_gpu_heightmap);
+    ClassDB::bind_method(D_METHOD("get_gpu_heightmap"), &TerrainGenerator::get_gpu_heightmap);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "gpu_heightmap"), "set_gpu_heightmap", "get_gpu_heightmap");
+
+    ClassDB::bind_method(D_METHOD("set_clipmap_mode", "_clipmap_mode"), &TerrainGenerator::set_clipmap_mode);
+    ClassDB::bind_method(D_METHOD("get_clipmap_mode"), &TerrainGenerator::get_clipmap_mode);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "clipmap_mode"), "set_clipmap_mode", "get_clipmap_mode");
+
+    ClassDB::bind_method(D_METHOD("set_clipmap_levels", "_clipmap_levels"), &TerrainGenerator::set_clipmap_levels);
+    ClassDB::bind_method(D_METHOD("get_clipmap_levels"), &TerrainGenerator::get_clipmap_levels);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "clipmap_levels", PROPERTY_HINT_RANGE, "1,12,1"), "set_clipmap_levels", "get_clipmap_levels");
+
+    ClassDB::bind_method(D_METHOD("set_clipmap_size", "_clipmap_size"), &TerrainGenerator::set_clipmap_size);
+    ClassDB::bind_method(D_METHOD("get_clipmap_size"), &TerrainGenerator::get_clipmap_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "clipmap_size", PROPERTY_HINT_RANGE, "6,510,4"), "set_clipmap_size", "get_clipmap_size");
+
+    ClassDB::bind_method(D_METHOD("set_clipmap_updates_per_frame", "_clipmap_updates_per_frame"), &TerrainGenerator::set_clipmap_updates_per_frame);
+    ClassDB::bind_method(D_METHOD("get_clipmap_updates_per_frame"), &TerrainGenerator::get_clipmap_updates_per_frame);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "clipmap_updates_per_frame", PROPERTY_HINT_RANGE, "2,1024,1"), "set_clipmap_updates_per_frame", "get_clipmap_updates_per_frame");
+
+    ClassDB::bind_method(D_METHOD("set_sea_level", "_sea_level"), &TerrainGenerator::set_sea_level);
+    ClassDB::bind_method(D_METHOD("get_sea_level"), &TerrainGenerator::get_sea_level);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sea_level", PROPERTY_HINT_RANGE, "-100.0, 100.0, 0.1"), "set_sea_level", "get_sea_level");
+
+    ClassDB::bind_method(D_METHOD("set_skip_underwater_chunks", "_skip_underwater_chunks"), &TerrainGenerator::set_skip_underwater_chunks);
+    ClassDB::bind_method(D_METHOD("get_skip_underwater_chunks"), &TerrainGenerator::get_skip_underwater_chunks);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "skip_underwater_chunks"), "set_skip_underwater_chunks", "get_skip_underwater_chunks");
+
     ClassDB::bind_method(D_METHOD("set_foliage_scene", "_foliage_scene"), &TerrainGenerator::set_foliage_scene);
     ClassDB::bind_method(D_METHOD("get_foliage_scene"), &TerrainGenerator::get_foliage_scene);
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "foliage_scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_foliage_scene", "get_foliage_scene");
@@ -125,16 +200,45 @@ void TerrainGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_river_material"), &TerrainGenerator::get_river_material);
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "river_material", PROPERTY_HINT_RESOURCE_TYPE, "Material"), "set_river_material", "get_river_material");
 
+    // Native noise evaluation properties
+    ClassDB::bind_method(D_METHOD("set_use_native_noise", "_use_native_noise"), &TerrainGenerator::set_use_native_noise);
+    ClassDB::bind_method(D_METHOD("get_use_native_noise"), &TerrainGenerator::get_use_native_noise);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_native_noise"), "set_use_native_noise", "get_use_native_noise");
+
+    ClassDB::bind_method(D_METHOD("set_validate_native_noise", "_validate_native_noise"), &TerrainGenerator::set_validate_native_noise);
+    ClassDB::bind_method(D_METHOD("get_validate_native_noise"), &TerrainGenerator::get_validate_native_noise);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "validate_native_noise"), "set_validate_native_noise", "get_validate_native_noise");
+
+    ClassDB::bind_method(D_METHOD("set_height_cache_size_mb", "_height_cache_size_mb"), &TerrainGenerator::set_height_cache_size_mb);
+    ClassDB::bind_method(D_METHOD("get_height_cache_size_mb"), &TerrainGenerator::get_height_cache_size_mb);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "height_cache_size_mb", PROPERTY_HINT_RANGE, "0, 1024, 1"), "set_height_cache_size_mb", "get_height_cache_size_mb");
+
+    ClassDB::bind_method(D_METHOD("set_multi_rate_noise", "_multi_rate_noise"), &TerrainGenerator::set_multi_rate_noise);
+    ClassDB::bind_method(D_METHOD("get_multi_rate_noise"), &TerrainGenerator::get_multi_rate_noise);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "multi_rate_noise"), "set_multi_rate_noise", "get_multi_rate_noise");
+
+    ClassDB::bind_method(D_METHOD("set_multi_rate_error_budget", "_multi_rate_error_budget"), &TerrainGenerator::set_multi_rate_error_budget);
+    ClassDB::bind_method(D_METHOD("get_multi_rate_error_budget"), &TerrainGenerator::get_multi_rate_error_budget);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "multi_rate_error_budget", PROPERTY_HINT_RANGE, "0.0001, 0.05, 0.0001"), "set_multi_rate_error_budget", "get_multi_rate_error_budget");
+
     // Debug method for monitoring chunk memory usage
     ClassDB::bind_method(D_METHOD("get_chunk_stats"), &TerrainGenerator::get_chunk_stats);
 
+    // Debug method for monitoring the shared height tile cache
+    ClassDB::bind_method(D_METHOD("get_height_cache_stats"), &TerrainGenerator::get_height_cache_stats);
+    ClassDB::bind_method(D_METHOD("get_clipmap_stats"), &TerrainGenerator::get_clipmap_stats);
+
+    // River distance field of a chunk as an RGBA float image (distance, width, t, carving)
+    ClassDB::bind_method(D_METHOD("get_river_distance_image", "chunk_position"), &TerrainGenerator::get_river_distance_image);
+
     // Method to reload all terrain chunks
     ClassDB::bind_method(D_METHOD("reload_chunks"), &TerrainGenerator::reload_chunks);
 }
 
 TerrainGenerator::TerrainGenerator()
-    : height_sampler(nullptr), mesh_generator(nullptr),
+    : height_sampler(nullptr), mesh_generator(nullptr), heightmap_renderer(nullptr), clipmap_renderer(nullptr),
       foliage_generator(nullptr), river_generator(nullptr), chunk_manager(nullptr) {
+    refresh_carving_falloff();
     recreate_components();
 }
 
@@ -143,6 +247,10 @@ TerrainGenerator::~TerrainGenerator() {
         delete chunk_manager;
         chunk_manager = nullptr;
     }
+    if (clipmap_renderer) {
+        delete clipmap_renderer;
+        clipmap_renderer = nullptr;
+    }
     if (foliage_generator) {
         delete foliage_generator;
         foliage_generator = nullptr;
@@ -155,6 +263,10 @@ TerrainGenerator::~TerrainGenerator() {
         delete mesh_generator;
         mesh_generator = nullptr;
     }
+    if (heightmap_renderer) {
+        delete heightmap_renderer;
+        heightmap_renderer = nullptr;
+    }
     if (height_sampler) {
         delete height_sampler;
         height_sampler = nullptr;
@@ -167,6 +279,10 @@ void TerrainGenerator::recreate_components() {
         delete chunk_manager;
         chunk_manager = nullptr;
     }
+    if (clipmap_renderer) {
+        delete clipmap_renderer;
+        clipmap_renderer = nullptr;
+    }
     if (foliage_generator) {
         delete foliage_generator;
         foliage_generator = nullptr;
@@ -179,18 +295,27 @@ void TerrainGenerator::recreate_components() {
         delete mesh_generator;
         mesh_generator = nullptr;
     }
+    if (heightmap_renderer) {
+        delete heightmap_renderer;
+        heightmap_renderer = nullptr;
+    }
     if (height_sampler) {
         delete height_sampler;
         height_sampler = nullptr;
     }
 
+    // Layer rates and the compiled graph depend on the lattice spacing (width / segment_count)
+    refresh_native_noise();
+
     // Create new components
     height_sampler = new HeightSampler(&config);
     mesh_generator = new MeshGenerator(&config, height_sampler);
+    heightmap_renderer = new HeightmapRenderer(&config, height_sampler);
+    clipmap_renderer = new ClipmapRenderer(&config, height_sampler, this);
     foliage_generator = new FoliageGenerator(&config, height_sampler);
     river_generator = new RiverGenerator(&config, height_sampler);
     
-    chunk_manager = new ChunkManager(&config, mesh_generator, foliage_generator, river_generator, this);
+    chunk_manager = new ChunkManager(&config, mesh_generator, heightmap_renderer, foliage_generator, river_generator, this);
 }
 
 void TerrainGenerator::_ready() {
@@ -200,11 +325,46 @@ void TerrainGenerator::_ready() {
 }
 
 void TerrainGenerator::_process(double delta) {
+    // Frees noise and curve snapshots that no generation job can still be reading
+    config.snapshots.collect();
+
     Node3D *origin_node = get_node<Node3D>(origin_node_path);
     if (origin_node && chunk_manager) {
-        chunk_manager->update_origin_cache(origin_node->get_global_position());
+        chunk_manager->update_origin_cache(origin_node->get_global_position(), track_origin_motion(origin_node, delta));
         chunk_manager->process_chunks();
     }
+    if (origin_node && clipmap_renderer && config.clipmap_mode) {
+        clipmap_renderer->update(origin_node->get_global_position());
+    }
+}
+
+OriginMotion TerrainGenerator::track_origin_motion(Node3D* origin_node, double delta) {
+    OriginMotion motion;
+
+    Vector3 origin_position = origin_node->get_global_position();
+    if (origin_tracked && delta > 0.0) {
+        Vector3 frame_velocity = (origin_position - last_origin_position) / (float)delta;
+        // Teleports are not motion worth extrapolating
+        if (frame_velocity.length() > MAX_TRACKED_SPEED * config.width) {
+            frame_velocity = Vector3();
+        }
+        origin_velocity = origin_velocity.lerp(frame_velocity, std::min(1.0f, (float)delta * VELOCITY_SMOOTHING));
+    }
+    last_origin_position = origin_position;
+    origin_tracked = true;
+    motion.velocity = origin_velocity;
+
+    // The active camera decides what is on screen; without one, everything is
+    Viewport* viewport = get_viewport();
+    Camera3D* camera = viewport ? viewport->get_camera_3d() : nullptr;
+    if (camera) {
+        Vector2 viewport_size = viewport->get_visible_rect().size;
+        float aspect = viewport_size.y > 0.0f ? viewport_size.x / viewport_size.y : 1.0f;
+        float half_fov = camera->get_fov() * 0.5f * (float)Math_PI / 180.0f;  // Vertical
+        motion.view_direction = -camera->get_global_transform().basis.get_column(2);
+        motion.view_half_angle = std::atan(std::tan(half_fov) * aspect);
+    }
+    return motion;
 }
 
 // Property setters - Some trigger component recreation, others just update config
@@ -223,31 +383,198 @@ void TerrainGenerator::set_segment_count(int p_segment_count) {
 }
 
 void TerrainGenerator::set_continentalness_texture(Ref<NoiseTexture2D> p_noise_texture) {
+    watch_changed(config.continentalness_texture, p_noise_texture, callable_mp(this, &TerrainGenerator::refresh_native_noise));
     config.continentalness_texture = p_noise_texture;
+    refresh_native_noise();
 }
 
 void TerrainGenerator::set_peaks_and_valleys_texture(Ref<NoiseTexture2D> p_noise_texture) {
+    watch_changed(config.peaks_and_valleys_texture, p_noise_texture, callable_mp(this, &TerrainGenerator::refresh_native_noise));
     config.peaks_and_valleys_texture = p_noise_texture;
+    refresh_native_noise();
 }
 
 void TerrainGenerator::set_erosion_texture(Ref<NoiseTexture2D> p_noise_texture) {
+    watch_changed(config.erosion_texture, p_noise_texture, callable_mp(this, &TerrainGenerator::refresh_native_noise));
     config.erosion_texture = p_noise_texture;
+    refresh_native_noise();
+}
+
+void TerrainGenerator::set_use_native_noise(bool p_enable) {
+    if (config.use_native_noise != p_enable) {
+        config.use_native_noise = p_enable;
+        refresh_native_noise();
+    }
+}
+
+void TerrainGenerator::set_validate_native_noise(bool p_enable) {
+    if (config.validate_native_noise != p_enable) {
+        config.validate_native_noise = p_enable;
+        refresh_native_noise();
+    }
+}
+
+void TerrainGenerator::set_multi_rate_noise(bool p_enable) {
+    if (config.multi_rate_noise != p_enable) {
+        config.multi_rate_noise = p_enable;
+        refresh_native_noise();
+    }
+}
+
+void TerrainGenerator::set_multi_rate_error_budget(float p_budget) {
+    if (config.multi_rate_error_budget != p_budget) {
+        config.multi_rate_error_budget = p_budget;
+        refresh_native_noise();
+    }
+}
+
+static int layer_rate(const Ref<NoiseTexture2D>& texture, float spacing, float budget) {
+    return texture.is_valid() ? choose_noise_rate(texture->get_noise(), spacing, budget) : 1;
+}
+
+void TerrainGenerator::refresh_layer_rates(NativeNoiseLayers& layers) const {
+    if (!config.multi_rate_noise) {
+        return; // Every layer at full rate
+    }
+
+    float spacing = config.width / (float)config.segment_count;
+    float budget = config.multi_rate_error_budget;
+    layers.continentalness_rate = layer_rate(config.continentalness_texture, spacing, budget);
+    layers.peaks_and_valleys_rate = layer_rate(config.peaks_and_valleys_texture, spacing, budget);
+    layers.erosion_rate = layer_rate(config.erosion_texture, spacing, budget);
+}
+
+void TerrainGenerator::watch_changed(const Ref<Resource>& p_old, const Ref<Resource>& p_new, const Callable& p_callback) {
+    if (p_old.is_valid() && p_old->is_connected("changed", p_callback)) {
+        p_old->disconnect("changed", p_callback);
+    }
+    if (p_new.is_valid() && !p_new->is_connected("changed", p_callback)) {
+        p_new->connect("changed", p_callback);
+    }
+}
+
+void TerrainGenerator::refresh_curve_luts() {
+    // Baked aside and published whole; generation threads may be sampling the current tables
+    auto luts = std::make_unique<CurveLUTs>();
+    luts->continentalness.bake(config.continentalness_curve);
+    luts->peaks_and_valleys.bake(config.peaks_and_valleys_curve);
+    luts->erosion.bake(config.erosion_curve);
+    config.curve_luts.set(std::move(luts));
+
+    if (height_sampler) {
+        height_sampler->clear_cache();
+    }
+}
+
+void TerrainGenerator::refresh_carving_falloff() {
+    // Baked aside and published whole; generation threads may be carving with the current table
+    config.carving_falloff_lut.set(std::make_unique<CarvingFalloffLUT>(config.river_carving_smoothness));
+}
+
+void TerrainGenerator::refresh_native_noise() {
+    // Built aside and published whole; generation threads may be sampling the current one
+    auto layers = std::make_unique<NativeNoiseLayers>();
+    refresh_native_noise_layer(layers->continentalness, config.continentalness_texture, "continentalness");
+    refresh_native_noise_layer(layers->peaks_and_valleys, config.peaks_and_valleys_texture, "peaks_and_valleys");
+    refresh_native_noise_layer(layers->erosion, config.erosion_texture, "erosion");
+    refresh_layer_rates(*layers);
+    config.native_noise.set(std::move(layers));
+    refresh_noise_graph();
+
+    if (height_sampler) {
+        height_sampler->clear_cache();
+    }
+}
+
+void TerrainGenerator::refresh_native_noise_layer(NativeNoise& native, const Ref<NoiseTexture2D>& texture, const char* layer_name) {
+    native.reset();
+
+    if (!config.use_native_noise || texture.is_null() || texture->get_noise().is_null()) {
+        return;
+    }
+
+    // Unsupported noise settings silently keep using Godot's evaluation
+    if (!native.configure(texture->get_noise())) {
+        return;
+    }
+
+    if (config.validate_native_noise) {
+        const int VALIDATION_SAMPLES = 256;
+        float max_error = 0.0f;
+        if (!native.validate(texture->get_noise(), VALIDATION_SAMPLES, config.native_noise_tolerance, &max_error)) {
+            UtilityFunctions::push_warning(String("Native noise for ") + layer_name +
+                                           " differs from Godot by " + String::num(max_error) +
+                                           ", falling back to Godot noise.");
+            native.reset();
+        }
+    }
 }
 
 void TerrainGenerator::set_continentalness_curve(Ref<Curve> p_curve) {
+    watch_changed(config.continentalness_curve, p_curve, callable_mp(this, &TerrainGenerator::refresh_curve_luts));
     config.continentalness_curve = p_curve;
+    refresh_curve_luts();
 }
 
 void TerrainGenerator::set_peaks_and_valleys_curve(Ref<Curve> p_curve) {
+    watch_changed(config.peaks_and_valleys_curve, p_curve, callable_mp(this, &TerrainGenerator::refresh_curve_luts));
     config.peaks_and_valleys_curve = p_curve;
+    refresh_curve_luts();
 }
 
 void TerrainGenerator::set_erosion_curve(Ref<Curve> p_curve) {
+    watch_changed(config.erosion_curve, p_curve, callable_mp(this, &TerrainGenerator::refresh_curve_luts));
     config.erosion_curve = p_curve;
+    refresh_curve_luts();
+}
+
+void TerrainGenerator::set_noise_graph(const Ref<TerrainNoiseGraph>& p_graph) {
+    Callable callback = callable_mp(this, &TerrainGenerator::refresh_noise_graph);
+    watch_changed(config.noise_graph, p_graph, callback);
+    config.noise_graph = p_graph;
+    refresh_noise_graph();
+}
+
+void TerrainGenerator::refresh_noise_graph() {
+    if (config.noise_graph.is_null()) {
+        config.noise_program.set(nullptr);
+        return;
+    }
+
+    NoiseProgram::CompileOptions options;
+    options.spacing = config.width / (float)config.segment_count;
+    options.use_native_noise = config.use_native_noise;
+    options.validate_native_noise = config.validate_native_noise;
+    options.native_noise_tolerance = config.native_noise_tolerance;
+    options.rate_error_budget = config.multi_rate_noise ? config.multi_rate_error_budget : 0.0f;
+
+    auto program = std::make_unique<NoiseProgram>();
+    String error = program->compile(config.noise_graph, options);
+    if (!error.is_empty()) {
+        // Keep generating with the layer textures until the graph is fixed
+        UtilityFunctions::push_warning("TerrainNoiseGraph: " + error);
+        config.noise_program.set(nullptr);
+    } else {
+        config.noise_program.set(std::move(program));
+    }
+
+    if (height_sampler) {
+        height_sampler->clear_cache();
+    }
 }
 
 void TerrainGenerator::set_height_scale(float p_height_scale) {
     config.height_scale = p_height_scale;
+    if (height_sampler) {
+        height_sampler->clear_cache();
+    }
+}
+
+void TerrainGenerator::set_height_cache_size_mb(int p_size_mb) {
+    config.height_cache_size_mb = p_size_mb;
+    if (height_sampler) {
+        height_sampler->set_cache_size((size_t)p_size_mb * 1024 * 1024);
+    }
 }
 
 void TerrainGenerator::set_terrain_material(Ref<Material> p_material) {
@@ -264,6 +591,105 @@ void TerrainGenerator::set_view_distance(int p_distance) {
     }
 }
 
+void TerrainGenerator::set_generation_threads(int p_threads) {
+    if (config.generation_threads != p_threads) {
+        config.generation_threads = p_threads;
+        // The job pool is sized when the loader starts; restart it
+        if (chunk_manager) {
+            chunk_manager->reload_chunks();
+        }
+    }
+}
+
+void TerrainGenerator::set_lod_levels(int p_levels) {
+    if (config.lod_levels != p_levels) {
+        config.lod_levels = p_levels;
+        // Loaded chunks swap their surfaces in place; nothing is reloaded
+        if (chunk_manager) {
+            chunk_manager->refresh_lods();
+        }
+    }
+}
+
+void TerrainGenerator::set_lod_distance(int p_distance) {
+    if (config.lod_distance != p_distance) {
+        config.lod_distance = p_distance;
+        if (chunk_manager) {
+            chunk_manager->refresh_lods();
+        }
+    }
+}
+
+void TerrainGenerator::set_mesh_simplification_tolerance(float p_tolerance) {
+    if (config.mesh_simplification_tolerance != p_tolerance) {
+        config.mesh_simplification_tolerance = p_tolerance;
+        // Simplified meshes are built at load time, so reload to apply the new tolerance
+        if (chunk_manager) {
+            chunk_manager->reload_chunks();
+        }
+    }
+}
+
+void TerrainGenerator::set_gpu_heightmap(bool p_enabled) {
+    if (config.gpu_heightmap != p_enabled) {
+        config.gpu_heightmap = p_enabled;
+        // Every chunk switches between vertex meshes and height tiles; reload chunks
+        if (chunk_manager) {
+            chunk_manager->reload_chunks();
+        }
+    }
+}
+
+void TerrainGenerator::set_clipmap_mode(bool p_enabled) {
+    if (config.clipmap_mode != p_enabled) {
+        config.clipmap_mode = p_enabled;
+        // Chunks gain or lose their terrain surfaces; the clipmap is rebuilt on its next update
+        if (clipmap_renderer) {
+            clipmap_renderer->clear();
+        }
+        if (chunk_manager) {
+            chunk_manager->reload_chunks();
+        }
+    }
+}
+
+void TerrainGenerator::set_clipmap_levels(int p_levels) {
+    if (config.clipmap_levels != p_levels) {
+        config.clipmap_levels = p_levels;
+        if (clipmap_renderer) {
+            clipmap_renderer->clear();
+        }
+    }
+}
+
+void TerrainGenerator::set_clipmap_size(int p_size) {
+    if (config.clipmap_size != p_size) {
+        config.clipmap_size = p_size;
+        if (clipmap_renderer) {
+            clipmap_renderer->clear();
+        }
+    }
+}
+
+void TerrainGenerator::set_sea_level(float p_sea_level) {
+    if (config.sea_level != p_sea_level) {
+        config.sea_level = p_sea_level;
+        // Rivers end at sea level and submerged chunks depend on it; reload chunks
+        if (chunk_manager) {
+            chunk_manager->reload_chunks();
+        }
+    }
+}
+
+void TerrainGenerator::set_skip_underwater_chunks(bool p_skip) {
+    if (config.skip_underwater_chunks != p_skip) {
+        config.skip_underwater_chunks = p_skip;
+        if (chunk_manager) {
+            chunk_manager->reload_chunks();
+        }
+    }
+}
+
 void TerrainGenerator::set_foliage_scene(Ref<PackedScene> p_scene) {
     config.foliage_scene = p_scene;
 }
@@ -301,6 +727,7 @@ void TerrainGenerator::set_river_carving_width_multiplier(float p_multiplier) {
 void TerrainGenerator::set_river_carving_smoothness(float p_smoothness) {
     if (config.river_carving_smoothness != p_smoothness) {
         config.river_carving_smoothness = p_smoothness;
+        refresh_carving_falloff();
         // River carving parameter change requires reloading chunks
         if (chunk_manager) {
             chunk_manager->reload_chunks();
@@ -440,6 +867,30 @@ Dictionary TerrainGenerator::get_chunk_stats() const {
     return Dictionary();
 }
 
+Dictionary TerrainGenerator::get_clipmap_stats() const {
+    if (clipmap_renderer) {
+        return clipmap_renderer->get_stats();
+    }
+    return Dictionary();
+}
+
+Dictionary TerrainGenerator::get_height_cache_stats() const {
+    if (height_sampler) {
+        return height_sampler->get_cache_stats();
+    }
+    return Dictionary();
+}
+
+Ref<Image> TerrainGenerator::get_river_distance_image(Vector2i chunk_position) const {
+    if (!river_generator) {
+        return Ref<Image>();
+    }
+
+    RiverDistanceField river_field;
+    river_generator->build_river_distance_field(chunk_position, river_field);
+    return river_field.create_image();
+}
+
 float TerrainGenerator::sample_height(float world_x, float world_z) const {
     if (height_sampler) {
         return height_sampler->sample_height(world_x, world_z);
@@ -9,6 +9,8 @@
 #include "terrain_config.h"
 #include "height_sampler.h"
 #include "mesh_generator.h"
+#include "heightmap_renderer.h"
+#include "clipmap_renderer.h"
 #include "foliage_generator.h"
 #include "chunk_manager.h"
 #include "river_generator.h"
@@ -25,10 +27,19 @@ private:
     // Components
     HeightSampler* height_sampler;
     MeshGenerator* mesh_generator;
+    HeightmapRenderer* heightmap_renderer;
+    ClipmapRenderer* clipmap_renderer;
     FoliageGenerator* foliage_generator;
     RiverGenerator* river_generator;
     ChunkManager* chunk_manager;
 
+    // Origin motion, smoothed over a few frames for chunk prioritisation
+    static constexpr float VELOCITY_SMOOTHING = 8.0f;   // Per second
+    static constexpr float MAX_TRACKED_SPEED = 50.0f;   // Chunks per second; faster moves are jumps
+    Vector3 last_origin_position;
+    Vector3 origin_velocity;
+    bool origin_tracked = false;
+
     // Property setters/getters
     void set_width(int p_width);
     int get_width() const { return config.width; }
@@ -57,6 +68,9 @@ private:
     void set_erosion_curve(Ref<Curve> p_curve);
     Ref<Curve> get_erosion_curve() const { return config.erosion_curve; }
 
+    void set_noise_graph(const Ref<TerrainNoiseGraph>& p_graph);
+    Ref<TerrainNoiseGraph> get_noise_graph() const { return config.noise_graph; }
+
     void set_height_scale(float p_height_scale);
     float get_height_scale() const { return config.height_scale; }
 
@@ -66,6 +80,54 @@ private:
     void set_view_distance(int p_distance);
     int get_view_distance() const { return config.view_distance; }
 
+    void set_generation_threads(int p_threads);
+    int get_generation_threads() const { return config.generation_threads; }
+
+    void set_chunk_integration_budget_usec(int p_usec) { config.chunk_integration_budget_usec = p_usec; }
+    int get_chunk_integration_budget_usec() const { return config.chunk_integration_budget_usec; }
+
+    void set_prefetch_time(float p_seconds) { config.prefetch_time = p_seconds; }
+    float get_prefetch_time() const { return config.prefetch_time; }
+
+    void set_offscreen_chunk_delay(float p_seconds) { config.offscreen_chunk_delay = p_seconds; }
+    float get_offscreen_chunk_delay() const { return config.offscreen_chunk_delay; }
+
+    void set_unload_margin(int p_margin) { config.unload_margin = p_margin; }
+    int get_unload_margin() const { return config.unload_margin; }
+
+    void set_unload_linger_time(float p_seconds) { config.unload_linger_time = p_seconds; }
+    float get_unload_linger_time() const { return config.unload_linger_time; }
+
+    void set_lod_levels(int p_levels);
+    int get_lod_levels() const { return config.lod_levels; }
+
+    void set_lod_distance(int p_distance);
+    int get_lod_distance() const { return config.lod_distance; }
+
+    void set_mesh_simplification_tolerance(float p_tolerance);
+    float get_mesh_simplification_tolerance() const { return config.mesh_simplification_tolerance; }
+
+    void set_gpu_heightmap(bool p_enabled);
+    bool get_gpu_heightmap() const { return config.gpu_heightmap; }
+
+    void set_clipmap_mode(bool p_enabled);
+    bool get_clipmap_mode() const { return config.clipmap_mode; }
+
+    void set_clipmap_levels(int p_levels);
+    int get_clipmap_levels() const { return config.clipmap_levels; }
+
+    void set_clipmap_size(int p_size);
+    int get_clipmap_size() const { return config.clipmap_size; }
+
+    void set_clipmap_updates_per_frame(int p_lines) { config.clipmap_updates_per_frame = p_lines; }
+    int get_clipmap_updates_per_frame() const { return config.clipmap_updates_per_frame; }
+
+    void set_sea_level(float p_sea_level);
+    float get_sea_level() const { return config.sea_level; }
+
+    void set_skip_underwater_chunks(bool p_skip);
+    bool get_skip_underwater_chunks() const { return config.skip_underwater_chunks; }
+
     void set_foliage_scene(Ref<PackedScene> p_scene);
     Ref<PackedScene> get_foliage_scene() const { return config.foliage_scene; }
 
@@ -118,8 +180,36 @@ private:
     void set_river_material(const Ref<Material>& p_material);
     Ref<Material> get_river_material() const { return config.river_material; }
 
+    // Native noise evaluation
+    void set_use_native_noise(bool p_enable);
+    bool get_use_native_noise() const { return config.use_native_noise; }
+
+    void set_validate_native_noise(bool p_enable);
+    bool get_validate_native_noise() const { return config.validate_native_noise; }
+
+    void set_height_cache_size_mb(int p_size_mb);
+    int get_height_cache_size_mb() const { return config.height_cache_size_mb; }
+
+    // Multi-rate noise evaluation
+    void set_multi_rate_noise(bool p_enable);
+    bool get_multi_rate_noise() const { return config.multi_rate_noise; }
+
+    void set_multi_rate_error_budget(float p_budget);
+    float get_multi_rate_error_budget() const { return config.multi_rate_error_budget; }
+
     void recreate_components();
 
+    // Keep derived data (native noise snapshots, curve LUTs) in sync with resources
+    void watch_changed(const Ref<Resource>& p_old, const Ref<Resource>& p_new, const Callable& p_callback);
+    void refresh_native_noise();
+    void refresh_curve_luts();
+    void refresh_carving_falloff();
+    void refresh_layer_rates(NativeNoiseLayers& layers) const;
+    OriginMotion track_origin_motion(Node3D* origin_node, double delta);
+
+    void refresh_noise_graph();
+    void refresh_native_noise_layer(NativeNoise& native, const Ref<NoiseTexture2D>& texture, const char* layer_name);
+
 protected:
     static void _bind_methods();
 
@@ -132,6 +222,9 @@ public:
 
     void reload_chunks();
     Dictionary get_chunk_stats() const;
+    Dictionary get_height_cache_stats() const;
+    Dictionary get_clipmap_stats() const;
+    Ref<Image> get_river_distance_image(Vector2i chunk_position) const;
 
     // Public interface for components to access
     float sample_height(float world_x, float world_z) const;
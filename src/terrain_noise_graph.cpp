@@ -0,0 +1,151 @@
+//==========================================
+// terrain_noise_graph.cpp
+//==========================================
+#include "terrain_noise_graph.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+using namespace godot;
+
+void TerrainNoiseNode::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_operation", "_operation"), &TerrainNoiseNode::set_operation);
+    ClassDB::bind_method(D_METHOD("get_operation"), &TerrainNoiseNode::get_operation);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "operation", PROPERTY_HINT_ENUM,
+                              "Constant,Noise,Add,Subtract,Multiply,Min,Max,Lerp,Abs,Ridge,Normalize,Curve"),
+                 "set_operation", "get_operation");
+
+    ClassDB::bind_method(D_METHOD("set_inputs", "_inputs"), &TerrainNoiseNode::set_inputs);
+    ClassDB::bind_method(D_METHOD("get_inputs"), &TerrainNoiseNode::get_inputs);
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "inputs"), "set_inputs", "get_inputs");
+
+    ClassDB::bind_method(D_METHOD("set_value", "_value"), &TerrainNoiseNode::set_value);
+    ClassDB::bind_method(D_METHOD("get_value"), &TerrainNoiseNode::get_value);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "value"), "set_value", "get_value");
+
+    ClassDB::bind_method(D_METHOD("set_noise", "_noise"), &TerrainNoiseNode::set_noise);
+    ClassDB::bind_method(D_METHOD("get_noise"), &TerrainNoiseNode::get_noise);
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "noise", PROPERTY_HINT_RESOURCE_TYPE, "Noise"), "set_noise", "get_noise");
+
+    ClassDB::bind_method(D_METHOD("set_curve", "_curve"), &TerrainNoiseNode::set_curve);
+    ClassDB::bind_method(D_METHOD("get_curve"), &TerrainNoiseNode::get_curve);
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"), "set_curve", "get_curve");
+
+    BIND_ENUM_CONSTANT(OP_CONSTANT);
+    BIND_ENUM_CONSTANT(OP_NOISE);
+    BIND_ENUM_CONSTANT(OP_ADD);
+    BIND_ENUM_CONSTANT(OP_SUBTRACT);
+    BIND_ENUM_CONSTANT(OP_MULTIPLY);
+    BIND_ENUM_CONSTANT(OP_MIN);
+    BIND_ENUM_CONSTANT(OP_MAX);
+    BIND_ENUM_CONSTANT(OP_LERP);
+    BIND_ENUM_CONSTANT(OP_ABS);
+    BIND_ENUM_CONSTANT(OP_RIDGE);
+    BIND_ENUM_CONSTANT(OP_NORMALIZE);
+    BIND_ENUM_CONSTANT(OP_CURVE);
+}
+
+void TerrainNoiseNode::set_operation(Operation p_operation) {
+    operation = p_operation;
+    emit_changed();
+}
+
+void TerrainNoiseNode::set_inputs(const PackedInt32Array& p_inputs) {
+    inputs = p_inputs;
+    emit_changed();
+}
+
+void TerrainNoiseNode::set_value(float p_value) {
+    value = p_value;
+    emit_changed();
+}
+
+void TerrainNoiseNode::set_noise(const Ref<Noise>& p_noise) {
+    Callable callback = callable_mp(this, &TerrainNoiseNode::on_resource_changed);
+    if (noise.is_valid() && noise->is_connected("changed", callback)) {
+        noise->disconnect("changed", callback);
+    }
+    noise = p_noise;
+    if (noise.is_valid()) {
+        noise->connect("changed", callback);
+    }
+    emit_changed();
+}
+
+void TerrainNoiseNode::set_curve(const Ref<Curve>& p_curve) {
+    Callable callback = callable_mp(this, &TerrainNoiseNode::on_resource_changed);
+    if (curve.is_valid() && curve->is_connected("changed", callback)) {
+        curve->disconnect("changed", callback);
+    }
+    curve = p_curve;
+    if (curve.is_valid()) {
+        curve->connect("changed", callback);
+    }
+    emit_changed();
+}
+
+void TerrainNoiseNode::on_resource_changed() {
+    emit_changed();
+}
+
+int TerrainNoiseNode::get_input_count(Operation p_operation) {
+    switch (p_operation) {
+        case OP_CONSTANT:
+        case OP_NOISE:
+            return 0;
+        case OP_ABS:
+        case OP_RIDGE:
+        case OP_NORMALIZE:
+        case OP_CURVE:
+            return 1;
+        case OP_LERP:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+void TerrainNoiseGraph::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_nodes", "_nodes"), &TerrainNoiseGraph::set_nodes);
+    ClassDB::bind_method(D_METHOD("get_nodes"), &TerrainNoiseGraph::get_nodes);
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "nodes", PROPERTY_HINT_ARRAY_TYPE, "TerrainNoiseNode"), "set_nodes", "get_nodes");
+
+    ClassDB::bind_method(D_METHOD("set_output_node", "_output_node"), &TerrainNoiseGraph::set_output_node);
+    ClassDB::bind_method(D_METHOD("get_output_node"), &TerrainNoiseGraph::get_output_node);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "output_node"), "set_output_node", "get_output_node");
+}
+
+void TerrainNoiseGraph::on_node_changed() {
+    emit_changed();
+}
+
+void TerrainNoiseGraph::set_nodes(const TypedArray<TerrainNoiseNode>& p_nodes) {
+    Callable callback = callable_mp(this, &TerrainNoiseGraph::on_node_changed);
+    for (int i = 0; i < nodes.size(); ++i) {
+        Ref<TerrainNoiseNode> node = nodes[i];
+        if (node.is_valid() && node->is_connected("changed", callback)) {
+            node->disconnect("changed", callback);
+        }
+    }
+
+    nodes = p_nodes;
+
+    for (int i = 0; i < nodes.size(); ++i) {
+        Ref<TerrainNoiseNode> node = nodes[i];
+        if (node.is_valid() && !node->is_connected("changed", callback)) {
+            node->connect("changed", callback);
+        }
+    }
+    emit_changed();
+}
+
+void TerrainNoiseGraph::set_output_node(int p_output_node) {
+    output_node = p_output_node;
+    emit_changed();
+}
+
+Ref<TerrainNoiseNode> TerrainNoiseGraph::get_node(int p_index) const {
+    if (p_index < 0 || p_index >= nodes.size()) {
+        return Ref<TerrainNoiseNode>();
+    }
+    return nodes[p_index];
+}
@@ -0,0 +1,99 @@
+//==========================================
+// terrain_noise_graph.h - Node graph describing the terrain height function
+//==========================================
+#ifndef TERRAIN_NOISE_GRAPH_H
+#define TERRAIN_NOISE_GRAPH_H
+
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/classes/noise.hpp>
+#include <godot_cpp/classes/curve.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+namespace godot {
+
+// One operation in a TerrainNoiseGraph. Inputs are indices into the graph's
+// node list; which inputs and fields are used depends on the operation.
+class TerrainNoiseNode : public Resource {
+    GDCLASS(TerrainNoiseNode, Resource)
+
+public:
+    enum Operation {
+        OP_CONSTANT,   // value
+        OP_NOISE,      // noise; optional inputs [warp_x, warp_z] scaled by value
+        OP_ADD,        // a + b
+        OP_SUBTRACT,   // a - b
+        OP_MULTIPLY,   // a * b
+        OP_MIN,        // min(a, b)
+        OP_MAX,        // max(a, b)
+        OP_LERP,       // a + (b - a) * t
+        OP_ABS,        // |a|
+        OP_RIDGE,      // 1 - |a|
+        OP_NORMALIZE,  // (a + 1) / 2, maps noise from [-1, 1] to [0, 1]
+        OP_CURVE,      // curve(a) over [0, 1]
+        OP_MAX_OPERATION
+    };
+
+private:
+    Operation operation = OP_CONSTANT;
+    PackedInt32Array inputs;
+    float value = 0.0f;
+    Ref<Noise> noise;
+    Ref<Curve> curve;
+
+    void on_resource_changed();
+
+protected:
+    static void _bind_methods();
+
+public:
+    void set_operation(Operation p_operation);
+    Operation get_operation() const { return operation; }
+
+    void set_inputs(const PackedInt32Array& p_inputs);
+    PackedInt32Array get_inputs() const { return inputs; }
+
+    void set_value(float p_value);
+    float get_value() const { return value; }
+
+    void set_noise(const Ref<Noise>& p_noise);
+    Ref<Noise> get_noise() const { return noise; }
+
+    void set_curve(const Ref<Curve>& p_curve);
+    Ref<Curve> get_curve() const { return curve; }
+
+    // Number of inputs the operation expects (OP_NOISE accepts 0 or 2)
+    static int get_input_count(Operation p_operation);
+};
+
+// Height function as a DAG of TerrainNoiseNodes. The output node's value is
+// multiplied by the generator's height_scale. Edits to any node re-emit
+// `changed` on the graph so the generator recompiles it.
+class TerrainNoiseGraph : public Resource {
+    GDCLASS(TerrainNoiseGraph, Resource)
+
+private:
+    TypedArray<TerrainNoiseNode> nodes;
+    int output_node = 0;
+
+    void on_node_changed();
+
+protected:
+    static void _bind_methods();
+
+public:
+    void set_nodes(const TypedArray<TerrainNoiseNode>& p_nodes);
+    TypedArray<TerrainNoiseNode> get_nodes() const { return nodes; }
+
+    void set_output_node(int p_output_node);
+    int get_output_node() const { return output_node; }
+
+    int get_node_count() const { return nodes.size(); }
+    Ref<TerrainNoiseNode> get_node(int p_index) const;
+};
+
+}
+
+VARIANT_ENUM_CAST(TerrainNoiseNode::Operation);
+
+#endif
@@ -90,6 +90,12 @@ inline std::vector<Vector2> poisson_disc_sample(float width, float height, float
     return points;
 }
 
+// Utility function: Integer division rounding toward negative infinity (lattice -> tile/cell index)
+inline int floor_div(int value, int divisor) {
+    int q = value / divisor;
+    return (value % divisor != 0 && value < 0) ? q - 1 : q;
+}
+
 // Utility function: Generate a random float in the range [0.0, 1.0) using a seed and position
 inline float random_float(const Vector2& pos, uint32_t seed = 0) {
     // Convert floats to fixed-point for consistent hashing
@@ -0,0 +1,177 @@
+//==========================================
+// vertex_cache_optimizer.cpp
+//==========================================
+#include "vertex_cache_optimizer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+namespace {
+
+constexpr int CACHE_SIZE = 32;           // Simulated LRU size used for scoring
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+struct VertexState {
+    int cache_position = -1;
+    int remaining = 0;       // Triangles still to be emitted that use this vertex
+    int first_triangle = 0;  // Offset into the vertex -> triangle adjacency list
+    float score = 0.0f;
+};
+
+float vertex_score(const VertexState& vertex) {
+    if (vertex.remaining == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (vertex.cache_position >= 0) {
+        if (vertex.cache_position < 3) {
+            // Vertices of the triangle just emitted: a fixed score so the next
+            // triangle does not simply reuse the same edge forever
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            float scale = 1.0f / (CACHE_SIZE - 3);
+            score = std::pow(1.0f - (vertex.cache_position - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+
+    // Favour vertices with few triangles left so they leave the working set early
+    score += VALENCE_BOOST_SCALE * std::pow((float)vertex.remaining, -VALENCE_BOOST_POWER);
+    return score;
+}
+
+}
+
+void godot::optimize_vertex_cache(std::vector<int32_t>& indices, int vertex_count) {
+    int triangle_count = (int)indices.size() / 3;
+    if (triangle_count == 0 || vertex_count <= 0) {
+        return;
+    }
+
+    // Vertex -> triangle adjacency (CSR)
+    std::vector<VertexState> vertices(vertex_count);
+    for (int32_t index : indices) {
+        vertices[index].remaining++;
+    }
+    int offset = 0;
+    for (VertexState& vertex : vertices) {
+        vertex.first_triangle = offset;
+        offset += vertex.remaining;
+    }
+    std::vector<int> adjacency(offset);
+    std::vector<int> fill(vertex_count, 0);
+    for (int t = 0; t < triangle_count; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            int v = indices[t * 3 + k];
+            adjacency[vertices[v].first_triangle + fill[v]++] = t;
+        }
+    }
+
+    for (VertexState& vertex : vertices) {
+        vertex.score = vertex_score(vertex);
+    }
+
+    std::vector<float> triangle_score(triangle_count);
+    std::vector<uint8_t> emitted(triangle_count, 0);
+    for (int t = 0; t < triangle_count; ++t) {
+        triangle_score[t] = vertices[indices[t * 3]].score +
+                            vertices[indices[t * 3 + 1]].score +
+                            vertices[indices[t * 3 + 2]].score;
+    }
+
+    std::vector<int32_t> output;
+    output.reserve(indices.size());
+
+    // Cache holds up to CACHE_SIZE entries plus the three being inserted
+    int cache[CACHE_SIZE + 3];
+    int cache_count = 0;
+
+    int best_triangle = -1;
+    int scan_cursor = 0;  // Fallback linear scan when the cache offers nothing
+
+    for (int emitted_count = 0; emitted_count < triangle_count; ++emitted_count) {
+        if (best_triangle < 0) {
+            while (emitted[scan_cursor]) {
+                ++scan_cursor;
+            }
+            best_triangle = scan_cursor;
+        }
+
+        emitted[best_triangle] = 1;
+        const int32_t* corners = &indices[best_triangle * 3];
+
+        // Remove the triangle from its vertices' adjacency lists
+        for (int k = 0; k < 3; ++k) {
+            VertexState& vertex = vertices[corners[k]];
+            int* begin = &adjacency[vertex.first_triangle];
+            int* end = begin + vertex.remaining;
+            std::iter_swap(std::find(begin, end, best_triangle), end - 1);
+            vertex.remaining--;
+            output.push_back(corners[k]);
+        }
+
+        // Move the triangle's vertices to the front of the LRU
+        int new_cache[CACHE_SIZE + 3];
+        int new_count = 0;
+        for (int k = 0; k < 3; ++k) {
+            new_cache[new_count++] = corners[k];
+        }
+        for (int i = 0; i < cache_count; ++i) {
+            int v = cache[i];
+            if (v != corners[0] && v != corners[1] && v != corners[2]) {
+                new_cache[new_count++] = v;
+            }
+        }
+
+        // Rescore everything that was or is in the cache, then the triangles they touch
+        for (int i = 0; i < new_count; ++i) {
+            int v = new_cache[i];
+            vertices[v].cache_position = i < CACHE_SIZE ? i : -1;
+        }
+
+        best_triangle = -1;
+        float best_score = -1.0f;
+        for (int i = 0; i < new_count; ++i) {
+            VertexState& vertex = vertices[new_cache[i]];
+            float new_score = vertex_score(vertex);
+            float delta = new_score - vertex.score;
+            vertex.score = new_score;
+
+            for (int a = 0; a < vertex.remaining; ++a) {
+                int t = adjacency[vertex.first_triangle + a];
+                triangle_score[t] += delta;
+                if (triangle_score[t] > best_score) {
+                    best_score = triangle_score[t];
+                    best_triangle = t;
+                }
+            }
+        }
+
+        cache_count = std::min(new_count, CACHE_SIZE);
+        std::copy(new_cache, new_cache + cache_count, cache);
+    }
+
+    indices.swap(output);
+}
+
+float godot::average_cache_miss_ratio(const std::vector<int32_t>& indices, int vertex_count, int cache_size) {
+    int triangle_count = (int)indices.size() / 3;
+    if (triangle_count == 0) {
+        return 0.0f;
+    }
+
+    // FIFO cache as used by most hardware: entry times stamp when a vertex was loaded
+    std::vector<int> loaded_at(vertex_count, -1);
+    int misses = 0;
+    for (int32_t index : indices) {
+        if (loaded_at[index] < 0 || misses - loaded_at[index] >= cache_size) {
+            loaded_at[index] = misses;
+            misses++;
+        }
+    }
+    return misses / (float)triangle_count;
+}
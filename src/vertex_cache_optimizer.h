@@ -0,0 +1,24 @@
+//==========================================
+// vertex_cache_optimizer.h - Triangle reordering for the post-transform cache
+//==========================================
+#ifndef VERTEX_CACHE_OPTIMIZER_H
+#define VERTEX_CACHE_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Reorders the triangles of an indexed triangle list so consecutive
+// triangles reuse recently transformed vertices (Forsyth's linear-speed
+// algorithm). Vertex order and winding are unchanged, so the result can be
+// paired with any vertex buffer laid out for the input.
+void optimize_vertex_cache(std::vector<int32_t>& indices, int vertex_count);
+
+// Average number of vertex shader invocations per triangle for a FIFO cache
+// of cache_size entries (ACMR). 3.0 is the worst case, ~0.5 the limit for grids.
+float average_cache_miss_ratio(const std::vector<int32_t>& indices, int vertex_count, int cache_size = 16);
+
+}
+
+#endif